@@ -27,6 +27,8 @@
 #ifndef __optix_optix_primepp_h__
 #define __optix_optix_primepp_h__
 
+#include <cfloat>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -61,6 +63,40 @@ namespace optix {
     typedef Handle<QueryObj>      Query;      ///< Use this to manipulate RTPquery objects.
     /// @}
 
+    /****************************************
+     *
+     * HIT RECORDS
+     *
+     ****************************************/
+
+    /// \ingroup optixprimepp
+    ///
+    /// \brief A single intersection, laid out like an element of @ref RTP_BUFFER_FORMAT_HIT_T_TRIID_U_V.
+    struct Hit {
+      float t;      ///< Ray distance (t < 0 for miss)
+      int   triId;  ///< Triangle id
+      float u;      ///< Barycentric coordinate u
+      float v;      ///< Barycentric coordinate v (w=1-u-v)
+    };
+
+    /****************************************
+     *
+     * CALLBACKS
+     *
+     ****************************************/
+
+    /// \ingroup optixprimepp
+    ///
+    /// \brief Produces the rays [begin,end) of a query into \a rays, using the ray format given to @ref QueryObj::setRayGenerator.
+    /// Ray \a begin is stored at the start of \a rays.
+    typedef void (*RayGenerator)( void* userData, RTPsize begin, RTPsize end, void* rays );
+
+    /// \ingroup optixprimepp
+    ///
+    /// \brief Consumes the hits of rays [begin,end) of a query, stored in \a hits using the hit format given to @ref QueryObj::setHitSink.
+    /// The hit of ray \a begin is stored at the start of \a hits, and \a hits is only valid until the callback returns.
+    typedef void (*HitSink)( void* userData, RTPsize begin, RTPsize end, const void* hits );
+
     /****************************************
      *
      * REFERENCE COUNTED API - OBJECTS
@@ -85,6 +121,10 @@ namespace optix {
       
       /// Creates a Model object.  See @ref rtpModelCreate
       Model createModel();
+
+      /// Creates a Query object returning hits against several models, e.g. independently updated layers of a scene, without
+      /// merging their triangles. The models must belong to this context. See @ref QueryObj::setModelIds
+      Query createQuery( const std::vector<Model>& models, RTPquerytype queryType );
       
       //
       // API-FUNCTIONS
@@ -99,6 +139,11 @@ namespace optix {
       /// Sets the number of CPU threads used by a CPU context. See @ref rtpContextSetCpuThreads
       void setCpuThreads( unsigned numThreads );
 
+      /// Executes several queries of this context and returns once all of them have finished. Queries on the same model and of
+      /// the same type whose rays and hits were set in host memory with setRays( count, ... ) and setHits( count, ... ) are packed
+      /// into one execution, so many small ray batches share a single dispatch. Other queries are executed individually.
+      void executeBatch( const std::vector<Query>& queries );
+
       /// Returns a string describing last error encountered. See @ref rtpContextGetLastErrorString
       std::string getLastErrorString();
     
@@ -117,7 +162,18 @@ namespace optix {
       ~ContextObj();
       operator Context();
 
+      // Returns desc, recreated only if it does not describe buffer
+      RTPbufferdesc reuseBatchDesc( RTPbufferdesc& desc, void*& described, RTPbufferformat format, void* buffer );
+
       RTPcontext m_ctx;
+
+      // Scratch for executeBatch. The descriptors are raw handles, as a BufferDesc would keep this context alive.
+      std::vector<float> m_batchRays;
+      std::vector<Hit>   m_batchHits;
+      RTPbufferdesc      m_batchRaysDesc;
+      RTPbufferdesc      m_batchHitsDesc;
+      void*              m_batchRaysDescribed;
+      void*              m_batchHitsDescribed;
     };
 
     /// \ingroup optixprimepp
@@ -153,8 +209,14 @@ namespace optix {
       BufferDescObj( const Context& ctx, RTPbufferformat format, RTPbuffertype type, void* buffer );
       ~BufferDescObj();
 
+      bool describes( RTPbufferformat format, RTPbuffertype type, void* buffer ) const;
+
       RTPbufferdesc m_desc;
 
+      RTPbufferformat m_format;
+      RTPbuffertype   m_type;
+      void*           m_buffer;
+
       Context m_ctx;
     };
 
@@ -209,6 +271,10 @@ namespace optix {
       /// See @ref rtpModelSetBuilderParameter for additional information
       void setBuilderParameter( RTPbuilderparam param, RTPsize size, void* p );
 
+      /// Sets the double precision position that the model's float vertices are relative to. The default is the world origin.
+      /// Double precision rays set with QueryObj::setRays( count, format, rays ) are rebased to it. See @ref QueryObj::setRays
+      void setOrigin( double x, double y, double z );
+
       /// Returns the @ref RTPmodel model stored within this object.
       RTPmodel getRTPmodel() { return m_model; }
 
@@ -223,6 +289,7 @@ namespace optix {
 
       Context m_ctx;
       RTPmodel m_model;
+      double m_origin[3];
     };
 
     /// \ingroup optixprimepp
@@ -248,13 +315,38 @@ namespace optix {
       /// Sets the rays of a query from a buffer descriptor. See @ref rtpQuerySetRays
       void setRays( const BufferDesc& rays );
 
+      /// Sets host rays whose components are doubles, laid out like \a format. Ray origins are made relative to the model origin
+      /// given to ModelObj::setOrigin before they are converted to float, so rays and triangles far from the world origin keep
+      /// their precision. The rays are converted when this function is called. Not supported for queries created on several models.
+      void setRays( RTPsize count, RTPbufferformat format, const double* rays );
+
+      /// Generates the \a count rays of the query with \a generator instead of reading them from a ray buffer. Rays are produced
+      /// packet by packet into two reused host buffers, so the next packet is generated while the current one is traced. Without
+      /// a hit sink, hits are written to the hit buffer, which must have been set with setHits( count, format, type, hits ).
+      /// Setting rays or a null generator switches back to ray buffers.
+      void setRayGenerator( RTPsize count, RTPbufferformat format, RayGenerator generator, void* userData );
+
       /// Sets a hit buffer for the query. See @ref rtpQuerySetHits
       void setHits( RTPsize count, RTPbufferformat format, RTPbuffertype type, void* hits );
       
       /// Sets a hit buffer for the query from a buffer description. See @ref rtpQuerySetHits
       void setHits( const BufferDesc& hits );
 
-      /// Executes a raytracing query. See @ref rtpQueryExecute
+      /// Hands the hits of each packet of rays to \a sink while they are still in cache, instead of writing them to a hit buffer.
+      /// Packets are traced into two reused host buffers so that \a sink consumes one packet while the next is traced. Without a
+      /// ray generator, rays are read from the ray buffer, which must have been set with setRays( count, format, type, rays ).
+      /// Setting hits or a null sink switches back to hit buffers.
+      void setHitSink( RTPbufferformat format, HitSink sink, void* userData );
+
+      /// Sets the number of rays per packet used with a ray generator or hit sink, rounded up to a multiple of 32. The default is 65536.
+      void setPacketSize( RTPsize packetSize );
+
+      /// Sets a host buffer receiving, for each ray of a query created on several models, the index of the model the reported
+      /// triangle id belongs to, or -1 for a miss. Queries on a single model report 0 for a hit. Rays and hits must then be set
+      /// with setRays( count, ... ) and setHits( count, ... ). Pass 0 to stop reporting model indices.
+      void setModelIds( int* modelIds );
+
+      /// Executes a raytracing query. See @ref rtpQueryExecute. Queries using a ray generator or hit sink return only once all packets are traced.
       void execute( unsigned hint );
 
       /// Returns the @ref RTPquery query stored within this object.
@@ -266,10 +358,71 @@ namespace optix {
       friend class ModelObj;
 
       QueryObj( const Model& model, RTPquerytype queryType );
+      QueryObj( const std::vector<Model>& models, RTPquerytype queryType );
       ~QueryObj();
 
       Model m_model;
       RTPquery m_query;
+      RTPquerytype m_queryType;
+
+      // Additional models of a query created with ContextObj::createQuery, and their queries
+      std::vector<Model>    m_layers;
+      std::vector<RTPquery> m_layerQueries;
+      int*                  m_modelIds;
+
+      // Buffers last set by the application, restored after the query has been pointed at internal buffers
+      BufferDesc m_rayDesc;
+      BufferDesc m_hitDesc;
+
+      // Descriptors kept across calls so that setting the same buffers again or re-executing does not allocate
+      BufferDesc m_hostRayDesc;
+      BufferDesc m_hostHitDesc;
+      BufferDesc m_passRaysDesc;
+      BufferDesc m_passHitsDesc;
+      BufferDesc m_packetRaysDesc[2];
+      BufferDesc m_packetHitsDesc[2];
+
+      // Rays set with setRays( count, format, type, rays ), or 0
+      void*           m_rays;
+      RTPsize         m_rayCount;
+      RTPbufferformat m_rayFormat;
+      RTPbuffertype   m_rayType;
+
+      // Hits set with setHits( count, format, type, hits ), or 0
+      void*           m_hits;
+      RTPsize         m_hitCount;
+      RTPbufferformat m_hitFormat;
+      RTPbuffertype   m_hitType;
+
+      // Packet execution, see setRayGenerator and setHitSink
+      RayGenerator    m_rayGenerator;
+      void*           m_rayGeneratorData;
+      RTPsize         m_generatedRayCount;
+      RTPbufferformat m_generatedRayFormat;
+      HitSink         m_hitSink;
+      void*           m_hitSinkData;
+      RTPbufferformat m_hitSinkFormat;
+      RTPsize         m_packetSize;
+      std::vector<float> m_rayPackets[2];
+      std::vector<float> m_hitPackets[2];
+
+      // Scratch for queries on several models
+      std::vector<Hit>     m_bestHits;
+      std::vector<float>   m_passRays;
+      std::vector<Hit>     m_passHits;
+      std::vector<RTPsize> m_passRayIds;
+
+      // Double precision rays converted to float relative to the model origin
+      std::vector<float> m_rebasedRays;
+
+      BufferDesc& reuseBufferDesc( BufferDesc& desc, RTPbufferformat format, RTPbuffertype type, void* buffer );
+      bool isPackable() const;
+      void copyRays( float* rays ) const;
+      void storeHits( const Hit* hits );
+      void expandRays();
+      void executePackets();
+      void executeLayers();
+      void restoreBuffersAfterError();
     };
 
     /****************************************
@@ -286,6 +439,9 @@ namespace optix {
       /// Returns a string describing last error encountered. See @ref rtpContextGetLastErrorString
       static Exception makeException( RTPresult code, RTPcontext context );
 
+      /// Creates an exception for an error detected by the wrapper itself rather than by OptiX Prime
+      static Exception makeException( RTPresult code, const std::string& message );
+
       /// Stores the @ref RTPresult error code for this exception
       RTPresult getErrorCode() const;
       /// Stores the human-readable error string associated with this exception
@@ -333,8 +489,17 @@ namespace optix {
       Model h( new ModelObj(*this) );
       return h;
     }
+
+    inline Query ContextObj::createQuery( const std::vector<Model>& models, RTPquerytype queryType )
+    {
+      if( models.empty() )
+        throw Exception::makeException( RTP_ERROR_INVALID_VALUE, "createQuery requires at least one model" );
+
+      Query h( new QueryObj(models, queryType) );
+      return h;
+    }
     
-    inline ContextObj::ContextObj( RTPcontexttype type ) : m_ctx(0) {
+    inline ContextObj::ContextObj( RTPcontexttype type ) : m_ctx(0), m_batchRaysDesc(0), m_batchHitsDesc(0), m_batchRaysDescribed(0), m_batchHitsDescribed(0) {
       RTPresult r = rtpContextCreate( type, &m_ctx );
       if( r!=RTP_SUCCESS )
         m_ctx = 0;
@@ -343,6 +508,10 @@ namespace optix {
     }
 
     inline ContextObj::~ContextObj() {
+      if( m_batchRaysDesc )
+        rtpBufferDescDestroy( m_batchRaysDesc );
+      if( m_batchHitsDesc )
+        rtpBufferDescDestroy( m_batchHitsDesc );
       if( m_ctx ) {
         RTPresult r = rtpContextDestroy( m_ctx );
         if( r!=RTP_SUCCESS )
@@ -369,6 +538,123 @@ namespace optix {
       CHK( rtpContextSetCpuThreads(m_ctx, numThreads) );
     }
 
+    inline void ContextObj::executeBatch( const std::vector<Query>& queries )
+    {
+      // Group packable queries by model and query type, the first query of each group executing for the whole group
+      const size_t unpacked = ~size_t(0);
+      std::vector<size_t>  leaders;
+      std::vector<size_t>  group( queries.size(), unpacked );
+      std::vector<RTPsize> groupCounts;
+      for( size_t i = 0; i < queries.size(); ++i ) {
+        const Query& query = queries[i];
+        if( !query->isPackable() )
+          continue;
+        for( size_t g = 0; g < leaders.size(); ++g ) {
+          const Query& leader = queries[leaders[g]];
+          if( leader->m_model->getRTPmodel() == query->m_model->getRTPmodel() && leader->m_queryType == query->m_queryType ) {
+            group[i] = g;
+            break;
+          }
+        }
+        if( group[i] == unpacked ) {
+          group[i] = leaders.size();
+          leaders.push_back( i );
+          groupCounts.push_back( 0 );
+        }
+        groupCounts[group[i]] += query->m_rayCount;
+      }
+
+      // Lay out the groups one after another in the scratch buffers
+      RTPsize total = 0;
+      std::vector<RTPsize> groupOffsets( leaders.size() );
+      for( size_t g = 0; g < leaders.size(); ++g ) {
+        groupOffsets[g] = total;
+        total += groupCounts[g];
+      }
+      m_batchRays.resize( 8*total );
+      m_batchHits.resize( total );
+
+      std::vector<RTPsize> offsets( queries.size() );
+      std::vector<RTPsize> fill( groupOffsets );
+      for( size_t i = 0; i < queries.size(); ++i ) {
+        if( group[i] == unpacked )
+          continue;
+        offsets[i] = fill[group[i]];
+        fill[group[i]] += queries[i]->m_rayCount;
+        if( queries[i]->m_rayCount )
+          queries[i]->copyRays( &m_batchRays[8*offsets[i]] );
+      }
+
+      // Start everything asynchronously, so groups on different models and unpacked queries overlap. The scratch
+      // descriptors are only recreated when the scratch buffers have moved.
+      RTPbufferdesc raysDesc = 0;
+      RTPbufferdesc hitsDesc = 0;
+      if( total ) {
+        raysDesc = reuseBatchDesc( m_batchRaysDesc, m_batchRaysDescribed, RTP_BUFFER_FORMAT_RAY_ORIGIN_TMIN_DIRECTION_TMAX, &m_batchRays[0] );
+        hitsDesc = reuseBatchDesc( m_batchHitsDesc, m_batchHitsDescribed, RTP_BUFFER_FORMAT_HIT_T_TRIID_U_V, &m_batchHits[0] );
+      }
+      size_t redirected = 0;  // Leaders [0,redirected) may point at the scratch buffers
+      try {
+        for( size_t g = 0; g < leaders.size(); ++g ) {
+          if( !groupCounts[g] )
+            continue;
+          RTPquery query = queries[leaders[g]]->m_query;
+          CHK( rtpBufferDescSetRange(raysDesc, groupOffsets[g], groupOffsets[g] + groupCounts[g]) );
+          CHK( rtpBufferDescSetRange(hitsDesc, groupOffsets[g], groupOffsets[g] + groupCounts[g]) );
+          redirected = g + 1;
+          CHK( rtpQuerySetRays(query, raysDesc) );
+          CHK( rtpQuerySetHits(query, hitsDesc) );
+          CHK( rtpQueryExecute(query, RTP_QUERY_HINT_ASYNC) );
+        }
+        for( size_t i = 0; i < queries.size(); ++i ) {
+          if( group[i] == unpacked )
+            queries[i]->execute( RTP_QUERY_HINT_ASYNC );
+        }
+
+        // Restore the leaders' buffers
+        for( size_t g = 0; g < leaders.size(); ++g ) {
+          const Query& leader = queries[leaders[g]];
+          if( groupCounts[g] ) {
+            CHK( rtpQueryFinish(leader->m_query) );
+            CHK( rtpQuerySetRays(leader->m_query, leader->m_rayDesc->getRTPbufferdesc()) );
+            CHK( rtpQuerySetHits(leader->m_query, leader->m_hitDesc->getRTPbufferdesc()) );
+          }
+        }
+      } catch( ... ) {
+        // Leave no leader pointing at the scratch buffers, which the next batch overwrites
+        for( size_t g = 0; g < redirected; ++g ) {
+          const Query& leader = queries[leaders[g]];
+          if( groupCounts[g] ) {
+            rtpQueryFinish( leader->m_query );
+            rtpQuerySetRays( leader->m_query, leader->m_rayDesc->getRTPbufferdesc() );
+            rtpQuerySetHits( leader->m_query, leader->m_hitDesc->getRTPbufferdesc() );
+          }
+        }
+        throw;
+      }
+
+      // Scatter the hits back
+      for( size_t i = 0; i < queries.size(); ++i ) {
+        if( group[i] == unpacked )
+          queries[i]->finish();
+        else if( queries[i]->m_rayCount )
+          queries[i]->storeHits( &m_batchHits[offsets[i]] );
+      }
+    }
+
+    inline RTPbufferdesc ContextObj::reuseBatchDesc( RTPbufferdesc& desc, void*& described, RTPbufferformat format, void* buffer )
+    {
+      if( desc && described == buffer )
+        return desc;
+      if( desc ) {
+        rtpBufferDescDestroy( desc );
+        desc = 0;
+      }
+      CHK( rtpBufferDescCreate(m_ctx, format, RTP_BUFFER_TYPE_HOST, buffer, &desc) );
+      described = buffer;
+      return desc;
+    }
+
     inline std::string ContextObj::getLastErrorString()
     {
       const char* str;
@@ -396,7 +682,7 @@ namespace optix {
     // BUFFERDESC
     //
 
-    inline BufferDescObj::BufferDescObj( const Context& ctx, RTPbufferformat format, RTPbuffertype type, void* buffer ) : m_desc(0) {
+    inline BufferDescObj::BufferDescObj( const Context& ctx, RTPbufferformat format, RTPbuffertype type, void* buffer ) : m_desc(0), m_format(format), m_type(type), m_buffer(buffer) {
       m_ctx = ctx;
 
       CHK( rtpBufferDescCreate(m_ctx->getRTPcontext(), format, type, buffer, &m_desc) );
@@ -433,12 +719,18 @@ namespace optix {
       return m_desc;
     }
 
+    inline bool BufferDescObj::describes( RTPbufferformat format, RTPbuffertype type, void* buffer ) const
+    {
+      return m_format == format && m_type == type && m_buffer == buffer;
+    }
+
     //
     // MODEL
     //
 
     inline ModelObj::ModelObj( const Context& ctx ) : m_model(0) {
       m_ctx = ctx;
+      m_origin[0] = m_origin[1] = m_origin[2] = 0.0;
 
       CHK( rtpModelCreate(m_ctx->getRTPcontext(), &m_model) );
     }
@@ -536,17 +828,54 @@ namespace optix {
       CHK( rtpModelSetBuilderParameter(m_model, param, size, p) );
     }
 
+    inline void ModelObj::setOrigin( double x, double y, double z )
+    {
+      m_origin[0] = x;
+      m_origin[1] = y;
+      m_origin[2] = z;
+    }
+
     //
     // QUERY
     //
 
-    inline QueryObj::QueryObj( const Model& model, RTPquerytype queryType ) : m_query(0) {
+    inline QueryObj::QueryObj( const Model& model, RTPquerytype queryType ) : m_query(0), m_queryType(queryType), m_modelIds(0), m_rays(0), m_rayCount(0), m_rayFormat(RTP_BUFFER_FORMAT_RAY_ORIGIN_DIRECTION), m_rayType(RTP_BUFFER_TYPE_HOST),
+      m_hits(0), m_hitCount(0), m_hitFormat(RTP_BUFFER_FORMAT_HIT_T_TRIID_U_V), m_hitType(RTP_BUFFER_TYPE_HOST), m_rayGenerator(0), m_rayGeneratorData(0),
+      m_generatedRayCount(0), m_generatedRayFormat(RTP_BUFFER_FORMAT_RAY_ORIGIN_DIRECTION), m_hitSink(0), m_hitSinkData(0), m_hitSinkFormat(RTP_BUFFER_FORMAT_HIT_T_TRIID_U_V), m_packetSize(65536) {
       m_model = model;
 
       CHK( rtpQueryCreate(model->getRTPmodel(), queryType, &m_query) );
     }
 
+    inline QueryObj::QueryObj( const std::vector<Model>& models, RTPquerytype queryType ) : m_query(0), m_queryType(queryType), m_modelIds(0), m_rays(0), m_rayCount(0), m_rayFormat(RTP_BUFFER_FORMAT_RAY_ORIGIN_DIRECTION), m_rayType(RTP_BUFFER_TYPE_HOST),
+      m_hits(0), m_hitCount(0), m_hitFormat(RTP_BUFFER_FORMAT_HIT_T_TRIID_U_V), m_hitType(RTP_BUFFER_TYPE_HOST), m_rayGenerator(0), m_rayGeneratorData(0),
+      m_generatedRayCount(0), m_generatedRayFormat(RTP_BUFFER_FORMAT_RAY_ORIGIN_DIRECTION), m_hitSink(0), m_hitSinkData(0), m_hitSinkFormat(RTP_BUFFER_FORMAT_HIT_T_TRIID_U_V), m_packetSize(65536) {
+      m_model = models[0];
+
+      CHK( rtpQueryCreate(m_model->getRTPmodel(), queryType, &m_query) );
+
+      // A throwing constructor does not run the destructor, so release the queries created so far here
+      try {
+        m_layers.reserve( models.size()-1 );
+        m_layerQueries.reserve( models.size()-1 );
+        for( size_t i = 1; i < models.size(); ++i ) {
+          RTPquery query = 0;
+          CHK( rtpQueryCreate(models[i]->getRTPmodel(), queryType, &query) );
+          m_layers.push_back( models[i] );
+          m_layerQueries.push_back( query );
+        }
+      } catch( ... ) {
+        for( size_t i = 0; i < m_layerQueries.size(); ++i )
+          rtpQueryDestroy( m_layerQueries[i] );
+        rtpQueryDestroy( m_query );
+        throw;
+      }
+    }
+
     inline QueryObj::~QueryObj() {
+      for( size_t i = 0; i < m_layerQueries.size(); ++i ) {
+        rtpQueryDestroy(m_layerQueries[i]);
+      }
       if( m_query ) {
         rtpQueryDestroy(m_query);
       }
@@ -560,32 +889,340 @@ namespace optix {
     inline void QueryObj::setRays( const BufferDesc& rays )
     {
       CHK( rtpQuerySetRays(m_query, rays->getRTPbufferdesc()) );
+      m_rayDesc      = rays;
+      m_rays         = 0;
+      m_rayGenerator = 0;
     }
 
     inline void QueryObj::setRays( RTPsize count, RTPbufferformat format, RTPbuffertype type, void* rays )
     {
-      BufferDesc desc(m_model->m_ctx->createBufferDesc(format, type, rays) );
+      BufferDesc& desc = reuseBufferDesc( m_hostRayDesc, format, type, rays );
       desc->setRange( 0, count );
 
       setRays( desc );
+
+      m_rays      = rays;
+      m_rayCount  = count;
+      m_rayFormat = format;
+      m_rayType   = type;
+    }
+
+    inline void QueryObj::setRays( RTPsize count, RTPbufferformat format, const double* rays )
+    {
+      if( format != RTP_BUFFER_FORMAT_RAY_ORIGIN_DIRECTION && format != RTP_BUFFER_FORMAT_RAY_ORIGIN_TMIN_DIRECTION_TMAX )
+        throw Exception::makeException( RTP_ERROR_INVALID_VALUE, "setRays requires a ray buffer format" );
+      if( !m_layerQueries.empty() )
+        throw Exception::makeException( RTP_ERROR_NOT_SUPPORTED, "double precision rays are not supported for queries on several models" );
+
+      // Only the origin is rebased, so distances along the ray and hit t values are unchanged
+      const RTPsize components = format == RTP_BUFFER_FORMAT_RAY_ORIGIN_DIRECTION ? 6 : 8;
+      const double* origin = m_model->m_origin;
+      m_rebasedRays.resize( components*count + 1 ); // one spare element keeps &m_rebasedRays[0] valid for zero rays
+      for( RTPsize i = 0; i < count; ++i ) {
+        const double* src = rays + components*i;
+        float* ray = &m_rebasedRays[components*i];
+        for( int k = 0; k < 3; ++k )
+          ray[k] = (float)(src[k] - origin[k]);
+        for( RTPsize k = 3; k < components; ++k )
+          ray[k] = (float)src[k];
+      }
+
+      setRays( count, format, RTP_BUFFER_TYPE_HOST, &m_rebasedRays[0] );
+    }
+
+    inline void QueryObj::setRayGenerator( RTPsize count, RTPbufferformat format, RayGenerator generator, void* userData )
+    {
+      if( format != RTP_BUFFER_FORMAT_RAY_ORIGIN_DIRECTION && format != RTP_BUFFER_FORMAT_RAY_ORIGIN_TMIN_DIRECTION_TMAX )
+        throw Exception::makeException( RTP_ERROR_INVALID_VALUE, "setRayGenerator requires a ray buffer format" );
+
+      m_rayGenerator       = generator;
+      m_rayGeneratorData   = userData;
+      m_generatedRayCount  = count;
+      m_generatedRayFormat = format;
+
+      // The rays set last are kept, so that a null generator can point the query back at them
+      if( !generator && m_rayDesc.isValid() )
+        CHK( rtpQuerySetRays(m_query, m_rayDesc->getRTPbufferdesc()) );
     }
 
     inline void QueryObj::setHits( const BufferDesc& hits )
     {
       CHK( rtpQuerySetHits(m_query, hits->getRTPbufferdesc()) );
+      m_hitDesc = hits;
+      m_hits    = 0;
+      m_hitSink = 0;
+    }
+
+    inline void QueryObj::setHitSink( RTPbufferformat format, HitSink sink, void* userData )
+    {
+      if( format < RTP_BUFFER_FORMAT_HIT_BITMASK || format > RTP_BUFFER_FORMAT_HIT_T_TRIID_U_V )
+        throw Exception::makeException( RTP_ERROR_INVALID_VALUE, "setHitSink requires a hit buffer format" );
+
+      m_hitSink       = sink;
+      m_hitSinkData   = userData;
+      m_hitSinkFormat = format;
+    }
+
+    inline void QueryObj::setPacketSize( RTPsize packetSize )
+    {
+      // Keep packets word aligned within bitmask hit buffers
+      m_packetSize = packetSize ? (packetSize + 31) & ~RTPsize(31) : 32;
+    }
+
+    inline void QueryObj::setModelIds( int* modelIds )
+    {
+      m_modelIds = modelIds;
     }
 
     inline void QueryObj::setHits( RTPsize count, RTPbufferformat format, RTPbuffertype type, void* hits )
     {
-      BufferDesc desc(m_model->m_ctx->createBufferDesc(format, type, hits) );
+      BufferDesc& desc = reuseBufferDesc( m_hostHitDesc, format, type, hits );
       desc->setRange( 0, count );
 
       setHits( desc );
+
+      m_hits      = hits;
+      m_hitCount  = count;
+      m_hitFormat = format;
+      m_hitType   = type;
     }
 
     inline void QueryObj::execute( unsigned hint )
     {
-      CHK( rtpQueryExecute(m_query, hint) );
+      if( m_rayGenerator || m_hitSink )
+        executePackets();
+      else if( !m_layerQueries.empty() || m_modelIds )
+        executeLayers();
+      else
+        CHK( rtpQueryExecute(m_query, hint) );
+    }
+
+    inline BufferDesc& QueryObj::reuseBufferDesc( BufferDesc& desc, RTPbufferformat format, RTPbuffertype type, void* buffer )
+    {
+      if( !desc.isValid() || !desc->describes(format, type, buffer) )
+        desc = m_model->m_ctx->createBufferDesc( format, type, buffer );
+      return desc;
+    }
+
+    inline bool QueryObj::isPackable() const
+    {
+      return m_rays && m_rayType == RTP_BUFFER_TYPE_HOST && m_hits && m_hitType == RTP_BUFFER_TYPE_HOST && m_hitCount >= m_rayCount &&
+             !m_rayGenerator && !m_hitSink && m_layerQueries.empty() && !m_modelIds;
+    }
+
+    inline void QueryObj::copyRays( float* rays ) const
+    {
+      // Copy the application's host rays in the tmin/tmax format
+      if( m_rayFormat == RTP_BUFFER_FORMAT_RAY_ORIGIN_TMIN_DIRECTION_TMAX ) {
+        memcpy( rays, m_rays, 8*sizeof(float)*m_rayCount );
+        return;
+      }
+      for( RTPsize i = 0; i < m_rayCount; ++i ) {
+        const float* src = static_cast<const float*>(m_rays) + 6*i;
+        float* ray = rays + 8*i;
+        memcpy( ray,   src,   3*sizeof(float) );
+        memcpy( ray+4, src+3, 3*sizeof(float) );
+        ray[3] = 0.0f;
+        ray[7] = FLT_MAX;
+      }
+    }
+
+    inline void QueryObj::storeHits( const Hit* hits )
+    {
+      // Write hits to the application's host hit buffer in its format
+      for( RTPsize i = 0; i < m_rayCount; ++i ) {
+        const Hit& hit = hits[i];
+        switch( m_hitFormat ) {
+          case RTP_BUFFER_FORMAT_HIT_BITMASK: {
+            unsigned int* word = static_cast<unsigned int*>(m_hits) + i/32;
+            const unsigned int bit = 1u << (i%32);
+            *word = hit.t >= 0.0f ? (*word | bit) : (*word & ~bit);
+            break;
+          }
+          case RTP_BUFFER_FORMAT_HIT_T:
+            static_cast<float*>(m_hits)[i] = hit.t;
+            break;
+          case RTP_BUFFER_FORMAT_HIT_T_TRIID:
+            memcpy( static_cast<char*>(m_hits) + 8*i, &hit, 8 );
+            break;
+          default:
+            static_cast<Hit*>(m_hits)[i] = hit;
+            break;
+        }
+      }
+    }
+
+    inline void QueryObj::expandRays()
+    {
+      // Expand the application's rays into the tmin/tmax format so that they can be clipped between passes
+      const RTPsize count = m_rayCount;
+      m_passRays.resize( 8*count );
+      m_passRayIds.resize( count );
+      copyRays( &m_passRays[0] );
+      for( RTPsize i = 0; i < count; ++i )
+        m_passRayIds[i] = i;
+    }
+
+    inline void QueryObj::executeLayers()
+    {
+      if( !m_rays || m_rayType != RTP_BUFFER_TYPE_HOST || !m_hits || m_hitType != RTP_BUFFER_TYPE_HOST )
+        throw Exception::makeException( RTP_ERROR_NOT_SUPPORTED, "queries on several models require host rays and hits set with setRays( count, ... ) and setHits( count, ... )" );
+      if( m_hitCount < m_rayCount )
+        throw Exception::makeException( RTP_ERROR_INVALID_VALUE, "the hit buffer holds fewer elements than the ray buffer" );
+
+      const RTPsize count = m_rayCount;
+      if( count == 0 )
+        return;
+
+      expandRays();
+      const Hit miss = { -1.0f, -1, 0.0f, 0.0f };
+      m_bestHits.assign( count, miss );
+      if( m_modelIds ) {
+        for( RTPsize i = 0; i < count; ++i )
+          m_modelIds[i] = -1;
+      }
+
+      m_passHits.resize( count );
+      BufferDesc& raysDesc = reuseBufferDesc( m_passRaysDesc, RTP_BUFFER_FORMAT_RAY_ORIGIN_TMIN_DIRECTION_TMAX, RTP_BUFFER_TYPE_HOST, &m_passRays[0] );
+      BufferDesc& hitsDesc = reuseBufferDesc( m_passHitsDesc, RTP_BUFFER_FORMAT_HIT_T_TRIID_U_V, RTP_BUFFER_TYPE_HOST, &m_passHits[0] );
+
+      try {
+        RTPsize active = count;
+        for( size_t model = 0; model <= m_layerQueries.size() && active > 0; ++model ) {
+          RTPquery query = model == 0 ? m_query : m_layerQueries[model-1];
+
+          raysDesc->setRange( 0, active );
+          hitsDesc->setRange( 0, active );
+          CHK( rtpQuerySetRays(query, raysDesc->getRTPbufferdesc()) );
+          CHK( rtpQuerySetHits(query, hitsDesc->getRTPbufferdesc()) );
+          CHK( rtpQueryExecute(query, RTP_QUERY_HINT_NONE) );
+
+          // Closest hit queries clip each ray to the nearest hit so far, so later models can cull more of their hierarchy.
+          // Ties go to the lower model index. Any hit queries drop the rays that already hit.
+          RTPsize next = 0;
+          for( RTPsize i = 0; i < active; ++i ) {
+            const Hit& hit = m_passHits[i];
+            const RTPsize ray = m_passRayIds[i];
+            bool keep = true;
+            if( hit.t >= 0.0f && (m_bestHits[ray].t < 0.0f || hit.t < m_bestHits[ray].t) ) {
+              m_bestHits[ray] = hit;
+              if( m_modelIds )
+                m_modelIds[ray] = (int)model;
+              m_passRays[8*i+7] = hit.t;
+              keep = m_queryType == RTP_QUERY_TYPE_CLOSEST;
+            }
+            if( keep ) {
+              if( next != i ) {
+                memcpy( &m_passRays[8*next], &m_passRays[8*i], 8*sizeof(float) );
+                m_passRayIds[next] = ray;
+              }
+              ++next;
+            }
+          }
+          active = next;
+        }
+
+        storeHits( &m_bestHits[0] );
+      } catch( ... ) {
+        restoreBuffersAfterError();
+        throw;
+      }
+
+      // Restore the application's buffers
+      if( m_rayDesc.isValid() )
+        CHK( rtpQuerySetRays(m_query, m_rayDesc->getRTPbufferdesc()) );
+      if( m_hitDesc.isValid() )
+        CHK( rtpQuerySetHits(m_query, m_hitDesc->getRTPbufferdesc()) );
+    }
+
+    inline void QueryObj::executePackets()
+    {
+      if( !m_layerQueries.empty() || m_modelIds )
+        throw Exception::makeException( RTP_ERROR_NOT_SUPPORTED, "ray generators and hit sinks are not supported for queries on several models or reporting model ids" );
+      if( !m_rayGenerator && !m_rays )
+        throw Exception::makeException( RTP_ERROR_INVALID_VALUE, "a hit sink requires a ray generator or rays set with setRays( count, format, type, rays )" );
+
+      const RTPsize         count      = m_rayGenerator ? m_generatedRayCount : m_rayCount;
+      const RTPbufferformat rayFormat  = m_rayGenerator ? m_generatedRayFormat : m_rayFormat;
+      const RTPsize         packetSize = m_packetSize;
+      const RTPsize         rayFloats  = rayFormat == RTP_BUFFER_FORMAT_RAY_ORIGIN_DIRECTION ? 6 : 8;
+      if( !m_hitSink && (!m_hits || m_hitCount < count) )
+        throw Exception::makeException( RTP_ERROR_INVALID_VALUE, "a ray generator requires a hit sink or a hit buffer of at least as many elements, set with setHits( count, format, type, hits )" );
+
+      // Packets either live in two reused host buffers or are ranges of the application's buffers
+      BufferDesc* raysDesc = m_packetRaysDesc;
+      BufferDesc* hitsDesc = m_packetHitsDesc;
+      for( int i = 0; i < 2; ++i ) {
+        if( m_rayGenerator ) {
+          m_rayPackets[i].resize( rayFloats*packetSize );
+          reuseBufferDesc( raysDesc[i], rayFormat, RTP_BUFFER_TYPE_HOST, &m_rayPackets[i][0] );
+        } else {
+          reuseBufferDesc( raysDesc[i], rayFormat, m_rayType, m_rays );
+        }
+        if( m_hitSink ) {
+          m_hitPackets[i].resize( 4*packetSize );
+          reuseBufferDesc( hitsDesc[i], m_hitSinkFormat, RTP_BUFFER_TYPE_HOST, &m_hitPackets[i][0] );
+        } else {
+          reuseBufferDesc( hitsDesc[i], m_hitFormat, m_hitType, m_hits );
+        }
+      }
+
+      try {
+        // While a packet is traced, consume the hits of the previous one and generate the rays of the next one
+        int current = 0;
+        RTPsize previous = 0;
+        if( m_rayGenerator )
+          m_rayGenerator( m_rayGeneratorData, 0, packetSize < count ? packetSize : count, &m_rayPackets[0][0] );
+        for( RTPsize begin = 0; begin < count; ) {
+          const RTPsize end = count - begin > packetSize ? begin + packetSize : count;
+
+          if( m_rayGenerator )
+            raysDesc[current]->setRange( 0, end-begin );
+          else
+            raysDesc[current]->setRange( begin, end );
+          if( m_hitSink )
+            hitsDesc[current]->setRange( 0, end-begin );
+          else
+            hitsDesc[current]->setRange( begin, end );
+          CHK( rtpQuerySetRays(m_query, raysDesc[current]->getRTPbufferdesc()) );
+          CHK( rtpQuerySetHits(m_query, hitsDesc[current]->getRTPbufferdesc()) );
+          CHK( rtpQueryExecute(m_query, RTP_QUERY_HINT_ASYNC) );
+
+          if( m_hitSink && begin > 0 )
+            m_hitSink( m_hitSinkData, previous, begin, &m_hitPackets[current^1][0] );
+          if( m_rayGenerator && end < count ) {
+            const RTPsize nextEnd = count - end > packetSize ? end + packetSize : count;
+            m_rayGenerator( m_rayGeneratorData, end, nextEnd, &m_rayPackets[current^1][0] );
+          }
+
+          CHK( rtpQueryFinish(m_query) );
+          previous = begin;
+          begin    = end;
+          current ^= 1;
+        }
+        if( m_hitSink && count > 0 )
+          m_hitSink( m_hitSinkData, previous, count, &m_hitPackets[current^1][0] );
+      } catch( ... ) {
+        restoreBuffersAfterError();
+        throw;
+      }
+
+      // Restore the application's buffers
+      if( m_rayDesc.isValid() )
+        CHK( rtpQuerySetRays(m_query, m_rayDesc->getRTPbufferdesc()) );
+      if( m_hitDesc.isValid() )
+        CHK( rtpQuerySetHits(m_query, m_hitDesc->getRTPbufferdesc()) );
+    }
+
+    inline void QueryObj::restoreBuffersAfterError()
+    {
+      // Leave the query idle and pointing at the application's buffers rather than at internal ones. Called while an
+      // exception propagates, so errors are ignored in favour of the original one.
+      rtpQueryFinish( m_query );
+      if( m_rayDesc.isValid() )
+        rtpQuerySetRays( m_query, m_rayDesc->getRTPbufferdesc() );
+      if( m_hitDesc.isValid() )
+        rtpQuerySetHits( m_query, m_hitDesc->getRTPbufferdesc() );
     }
 
     inline void QueryObj::finish()
@@ -614,6 +1251,11 @@ namespace optix {
       return h;
     }
 
+    inline Exception Exception::makeException( RTPresult code, const std::string& message )
+    {
+      return Exception( message, code );
+    }
+
     inline Exception::Exception( const std::string& message, RTPresult error_code )
     : m_errorMessage(message), m_errorCode( error_code )
     {
@@ -48,6 +48,34 @@
 
 namespace optix {
 
+  /** A ray with its reciprocal direction precomputed, for slab tests against many boxes */
+  struct SlabRay
+  {
+    float3 origin;
+    float3 invDirection;
+    float  tmin;
+    float  tmax;
+  };
+
+  /** Prepares a ray for slab tests. Zero direction components give infinite reciprocals, which the slab test handles
+  * unless the origin lies exactly on a slab plane of that axis.
+  * @{
+  */
+  OPTIXU_INLINE RT_HOSTDEVICE SlabRay make_SlabRay( const float3& origin, const float3& direction, float tmin, float tmax )
+  {
+    SlabRay ray;
+    ray.origin       = origin;
+    ray.invDirection = make_float3( 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z );
+    ray.tmin         = tmin;
+    ray.tmax         = tmax;
+    return ray;
+  }
+  OPTIXU_INLINE RT_HOSTDEVICE SlabRay make_SlabRay( const Ray& ray )
+  {
+    return make_SlabRay( ray.origin, ray.direction, ray.tmin, ray.tmax );
+  }
+  /** @} */
+
  /**
   * @brief Axis-aligned bounding box
   * 
@@ -158,6 +186,10 @@ namespace optix {
     /** Check if the box is flat in at least one dimension  */
     RT_HOSTDEVICE bool isFlat() const;
 
+    /** Slab test against a ray. Returns true if the ray overlaps the box within [tmin,tmax], and the
+     t at which it enters and exits the box clipped to that interval. Invalid boxes are never hit. */
+    RT_HOSTDEVICE bool intersects( const SlabRay& ray, float& tenter, float& texit ) const;
+
     /** Compute the minimum Euclidean distance from a point on the
      surface of this Aabb to the point of interest */
     RT_HOSTDEVICE float distance( const float3& x ) const;
@@ -361,6 +393,15 @@ namespace optix {
            m_min.z == m_max.z;
   }
 
+  OPTIXU_INLINE RT_HOSTDEVICE bool Aabb::intersects( const SlabRay& ray, float& tenter, float& texit ) const
+  {
+    const float3 t0 = (m_min - ray.origin) * ray.invDirection;
+    const float3 t1 = (m_max - ray.origin) * ray.invDirection;
+    tenter = fmaxf( fmaxf( fminf(t0, t1) ), ray.tmin );
+    texit  = fminf( fminf( fmaxf(t0, t1) ), ray.tmax );
+    return tenter <= texit;
+  }
+
   OPTIXU_INLINE RT_HOSTDEVICE float Aabb::distance( const float3& x ) const
   {
     return sqrtf(distance2(x));
@@ -0,0 +1,397 @@
+
+/*
+ * Copyright (c) 2008 - 2010 NVIDIA Corporation.  All rights reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property and proprietary
+ * rights in and to this software, related documentation and any modifications thereto.
+ * Any use, reproduction, disclosure or distribution of this software and related
+ * documentation without an express license agreement from NVIDIA Corporation is strictly
+ * prohibited.
+ *
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, THIS SOFTWARE IS PROVIDED *AS IS*
+ * AND NVIDIA AND ITS SUPPLIERS DISCLAIM ALL WARRANTIES, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE.  IN NO EVENT SHALL NVIDIA OR ITS SUPPLIERS BE LIABLE FOR ANY
+ * SPECIAL, INCIDENTAL, INDIRECT, OR CONSEQUENTIAL DAMAGES WHATSOEVER (INCLUDING, WITHOUT
+ * LIMITATION, DAMAGES FOR LOSS OF BUSINESS PROFITS, BUSINESS INTERRUPTION, LOSS OF
+ * BUSINESS INFORMATION, OR ANY OTHER PECUNIARY LOSS) ARISING OUT OF THE USE OF OR
+ * INABILITY TO USE THIS SOFTWARE, EVEN IF NVIDIA HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES
+ */
+
+ /**
+ * @file   optixu_aabb_soa_namespace.h
+ * @author NVIDIA Corporation
+ * @brief  OptiX public API
+ *
+ * Slab tests of one ray against 4 or 8 boxes, or of 4 or 8 rays against one box, and bulk
+ * bounds of large triangle and box sets, for host code, using the packets of
+ * optixu_math_soa_namespace.h. Not included by optixu_aabb_namespace.h.
+ */
+
+#ifndef __optixu_optixu_aabb_soa_namespace_h__
+#define __optixu_optixu_aabb_soa_namespace_h__
+
+#include "optixu_aabb_namespace.h"
+#include "optixu_math_soa_namespace.h"
+
+#if !defined(__CUDACC__)
+
+#include <vector>
+
+// The bulk bounds helpers run on several threads on C++11 hosts. Define OPTIXU_NO_THREADS to keep them serial.
+#if !defined(OPTIXU_NO_THREADS) && (__cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L))
+#  include <thread>
+#  define OPTIXU_AABB_THREADS 1
+#endif
+
+// __forceinline__ works in cuda, VS, and with gcc.  Leave it as macro in case
+// we need to make this per-platform or we want to switch off inlining globally.
+#ifndef OPTIXU_INLINE
+#  define OPTIXU_INLINE_DEFINED 1
+#  define OPTIXU_INLINE __forceinline__
+#endif // OPTIXU_INLINE
+
+namespace optix {
+
+  /** Four boxes in SoA layout, for testing a ray against all of them at once. */
+  struct Aabbx4
+  {
+    float3x4 m_min;
+    float3x4 m_max;
+  };
+
+  /** Eight boxes in SoA layout, for testing a ray against all of them at once. */
+  struct Aabbx8
+  {
+    float3x8 m_min;
+    float3x8 m_max;
+  };
+
+  /** A packet of 4 rays prepared for slab tests. */
+  struct SlabRayx4
+  {
+    float3x4 origin;
+    float3x4 invDirection;
+    floatx4  tmin;
+    floatx4  tmax;
+  };
+
+  /** A packet of 8 rays prepared for slab tests. */
+  struct SlabRayx8
+  {
+    float3x8 origin;
+    float3x8 invDirection;
+    floatx8  tmin;
+    floatx8  tmax;
+  };
+
+  /** @cond */
+  // Lane by lane version of Aabb::intersects, with the same order of operations. The hit masks always match it; t
+  // only matches bit for bit if neither is compiled with FP contraction (FMA), e.g. with -ffp-contract=off.
+  template<typename Float3xN, typename FloatxN>
+  OPTIXU_INLINE int slabTest( const Float3xN& origin, const Float3xN& invDirection, const FloatxN& tmin, const FloatxN& tmax,
+                              const Float3xN& boxMin, const Float3xN& boxMax, FloatxN& tenter, FloatxN& texit )
+  {
+    const Float3xN t0 = (boxMin - origin) * invDirection;
+    const Float3xN t1 = (boxMax - origin) * invDirection;
+    const Float3xN tnear = fminf( t0, t1 );
+    const Float3xN tfar  = fmaxf( t0, t1 );
+    tenter = fmaxf( fmaxf( fmaxf(tnear.x, tnear.y), tnear.z ), tmin );
+    texit  = fminf( fminf( fminf(tfar.x, tfar.y), tfar.z ), tmax );
+    return lessEqualMask( tenter, texit );
+  }
+  /** @endcond */
+
+  /** Gathers 4 or 8 consecutive boxes into SoA layout
+  * @{
+  */
+  OPTIXU_INLINE Aabbx4 make_Aabbx4( const Aabb* boxes )
+  {
+    Aabbx4 r;
+    for( int i = 0; i < 4; ++i ) {
+      setByIndex( r.m_min, i, boxes[i].m_min );
+      setByIndex( r.m_max, i, boxes[i].m_max );
+    }
+    return r;
+  }
+  OPTIXU_INLINE Aabbx8 make_Aabbx8( const Aabb* boxes )
+  {
+    Aabbx8 r;
+    for( int i = 0; i < 8; ++i ) {
+      setByIndex( r.m_min, i, boxes[i].m_min );
+      setByIndex( r.m_max, i, boxes[i].m_max );
+    }
+    return r;
+  }
+  /** @} */
+
+  /** Gathers 4 or 8 consecutive rays into a packet
+  * @{
+  */
+  OPTIXU_INLINE SlabRayx4 make_SlabRayx4( const SlabRay* rays )
+  {
+    SlabRayx4 r;
+    for( int i = 0; i < 4; ++i ) {
+      setByIndex( r.origin, i, rays[i].origin );
+      setByIndex( r.invDirection, i, rays[i].invDirection );
+      setByIndex( r.tmin, i, rays[i].tmin );
+      setByIndex( r.tmax, i, rays[i].tmax );
+    }
+    return r;
+  }
+  OPTIXU_INLINE SlabRayx8 make_SlabRayx8( const SlabRay* rays )
+  {
+    SlabRayx8 r;
+    for( int i = 0; i < 8; ++i ) {
+      setByIndex( r.origin, i, rays[i].origin );
+      setByIndex( r.invDirection, i, rays[i].invDirection );
+      setByIndex( r.tmin, i, rays[i].tmin );
+      setByIndex( r.tmax, i, rays[i].tmax );
+    }
+    return r;
+  }
+  /** @} */
+
+  /** Slab test of one ray against 4 or 8 boxes. Returns a mask with bit i set if the ray overlaps box i, as
+  * Aabb::intersects decides it, and the entry and exit t per box.
+  * @{
+  */
+  OPTIXU_INLINE int intersect( const SlabRay& ray, const Aabbx4& boxes, floatx4& tenter, floatx4& texit )
+  {
+    return slabTest( make_float3x4(ray.origin), make_float3x4(ray.invDirection), make_floatx4(ray.tmin), make_floatx4(ray.tmax),
+                     boxes.m_min, boxes.m_max, tenter, texit );
+  }
+  OPTIXU_INLINE int intersect( const SlabRay& ray, const Aabbx8& boxes, floatx8& tenter, floatx8& texit )
+  {
+    return slabTest( make_float3x8(ray.origin), make_float3x8(ray.invDirection), make_floatx8(ray.tmin), make_floatx8(ray.tmax),
+                     boxes.m_min, boxes.m_max, tenter, texit );
+  }
+  /** @} */
+
+  /** Slab test of a packet of 4 or 8 rays against one box. Returns a mask with bit i set if ray i overlaps the box,
+  * as Aabb::intersects decides it, and the entry and exit t per ray.
+  * @{
+  */
+  OPTIXU_INLINE int intersect( const SlabRayx4& rays, const Aabb& box, floatx4& tenter, floatx4& texit )
+  {
+    return slabTest( rays.origin, rays.invDirection, rays.tmin, rays.tmax,
+                     make_float3x4(box.m_min), make_float3x4(box.m_max), tenter, texit );
+  }
+  OPTIXU_INLINE int intersect( const SlabRayx8& rays, const Aabb& box, floatx8& tenter, floatx8& texit )
+  {
+    return slabTest( rays.origin, rays.invDirection, rays.tmin, rays.tmax,
+                     make_float3x8(box.m_min), make_float3x8(box.m_max), tenter, texit );
+  }
+  /** @} */
+
+  /** @cond */
+  // Loads v into the first three lanes. If followed is true the float after v in memory is read into the fourth lane;
+  // otherwise the fourth lane repeats z. The fourth lane is never used.
+  OPTIXU_INLINE floatx4 loadx4( const float3& v, bool followed )
+  {
+    return followed ? loadx4( &v.x ) : make_floatx4( v.x, v.y, v.z, v.z );
+  }
+
+  // Bounds of triangle i in the first three lanes, as Aabb::set( v0, v1, v2 ) computes them
+  struct TriangleBoundsSource
+  {
+    const float3* vertices;
+    const int3*   indices;
+    RTsize        vertexCount;
+
+    void operator()( RTsize i, floatx4& lo, floatx4& hi ) const
+    {
+      const int3 idx = indices ? indices[i] : make_int3( int(3*i), int(3*i+1), int(3*i+2) );
+      const floatx4 v0 = loadx4( vertices[idx.x], RTsize(idx.x) + 1 < vertexCount );
+      const floatx4 v1 = loadx4( vertices[idx.y], RTsize(idx.y) + 1 < vertexCount );
+      const floatx4 v2 = loadx4( vertices[idx.z], RTsize(idx.z) + 1 < vertexCount );
+      lo = fminf( v0, fminf(v1,v2) );
+      hi = fmaxf( v0, fmaxf(v1,v2) );
+    }
+  };
+
+  // Bounds of box i in the first three lanes
+  struct BoxBoundsSource
+  {
+    const Aabb* boxes;
+    RTsize      count;
+
+    void operator()( RTsize i, floatx4& lo, floatx4& hi ) const
+    {
+      lo = loadx4( boxes[i].m_min, true );
+      hi = loadx4( boxes[i].m_max, i + 1 < count );
+    }
+  };
+
+  // Maps a centroid already scaled into [0,binCount] to its bin
+  OPTIXU_INLINE unsigned int binIndex( float k, unsigned int binCount )
+  {
+    const unsigned int b = (unsigned int)k;
+    return b < binCount ? b : binCount - 1;
+  }
+
+  // One thread's share of computeBounds. The first pass writes bounds[2*t] and bounds[2*t+1]; the second pass adds
+  // the bin counts of its range to counts + t*3*binCount.
+  template<typename Source>
+  struct BoundsTask
+  {
+    const Source* source;
+    RTsize        count;
+    unsigned int  threadCount;
+    Aabb*         bounds;
+    const Aabb*   centroidBounds;
+    unsigned int  binCount;
+    unsigned int* counts;
+
+    void operator()( unsigned int t ) const
+    {
+      const RTsize chunk = (count + threadCount - 1) / threadCount;
+      const RTsize begin = chunk*t < count ? chunk*t : count;
+      const RTsize end   = begin + chunk < count ? begin + chunk : count;
+      if( centroidBounds )
+        binRange( begin, end, counts + t*3*binCount );
+      else
+        boundsRange( begin, end, bounds[2*t], bounds[2*t+1] );
+    }
+
+    void boundsRange( RTsize begin, RTsize end, Aabb& b, Aabb& cb ) const
+    {
+      const floatx4 half = make_floatx4( 0.5f );
+      floatx4 lo = make_floatx4(  1e37f ), clo = lo;
+      floatx4 hi = make_floatx4( -1e37f ), chi = hi;
+      for( RTsize i = begin; i < end; ++i ) {
+        floatx4 l, h;
+        (*source)( i, l, h );
+        const floatx4 c = (l + h) * half;   // Same order of operations as Aabb::center()
+        lo  = fminf( lo, l );
+        hi  = fmaxf( hi, h );
+        clo = fminf( clo, c );
+        chi = fmaxf( chi, c );
+      }
+      b.set( make_float3( getByIndex(lo, 0), getByIndex(lo, 1), getByIndex(lo, 2) ),
+             make_float3( getByIndex(hi, 0), getByIndex(hi, 1), getByIndex(hi, 2) ) );
+      cb.set( make_float3( getByIndex(clo, 0), getByIndex(clo, 1), getByIndex(clo, 2) ),
+              make_float3( getByIndex(chi, 0), getByIndex(chi, 1), getByIndex(chi, 2) ) );
+    }
+
+    void binRange( RTsize begin, RTsize end, unsigned int* c ) const
+    {
+      const float3 extent = centroidBounds->m_max - centroidBounds->m_min;
+      const floatx4 half  = make_floatx4( 0.5f );
+      const floatx4 base  = make_floatx4( centroidBounds->m_min.x, centroidBounds->m_min.y, centroidBounds->m_min.z, 0.0f );
+      const floatx4 scale = make_floatx4( extent.x > 0.0f ? binCount / extent.x : 0.0f,
+                                          extent.y > 0.0f ? binCount / extent.y : 0.0f,
+                                          extent.z > 0.0f ? binCount / extent.z : 0.0f, 0.0f );
+      for( RTsize i = begin; i < end; ++i ) {
+        floatx4 l, h;
+        (*source)( i, l, h );
+        float k[4];
+        store( k, ((l + h) * half - base) * scale );
+        ++c[             binIndex(k[0], binCount)];
+        ++c[binCount   + binIndex(k[1], binCount)];
+        ++c[2*binCount + binIndex(k[2], binCount)];
+      }
+    }
+  };
+
+  // Runs task(0) .. task(threadCount-1), on separate threads where available. A thread that cannot be started has
+  // its share run on the calling thread instead.
+  template<typename Task>
+  OPTIXU_INLINE void runTasks( const Task& task, unsigned int threadCount )
+  {
+#if defined(OPTIXU_AABB_THREADS)
+    std::vector<std::thread> threads;
+    threads.reserve( threadCount );
+    for( unsigned int t = 1; t < threadCount; ++t ) {
+      try {
+        threads.push_back( std::thread( [&task, t]() { task( t ); } ) );
+      } catch( ... ) {
+        task( t );
+      }
+    }
+    task( 0 );
+    for( size_t i = 0; i < threads.size(); ++i )
+      threads[i].join();
+#else
+    for( unsigned int t = 0; t < threadCount; ++t )
+      task( t );
+#endif
+  }
+
+  template<typename Source>
+  OPTIXU_INLINE void computeBounds( const Source& source, RTsize count, Aabb& bounds, Aabb& centroidBounds,
+                                    unsigned int binCount, unsigned int* binCounts, unsigned int threadCount )
+  {
+#if defined(OPTIXU_AABB_THREADS)
+    if( threadCount == 0 )
+      threadCount = std::thread::hardware_concurrency();
+    // Not worth a thread for fewer than 64K primitives
+    const RTsize maxThreads = count / 65536 > 1 ? count / 65536 : 1;
+    threadCount = threadCount == 0 ? 1 : ( threadCount < maxThreads ? threadCount : (unsigned int)maxThreads );
+#else
+    threadCount = 1;
+#endif
+
+    std::vector<Aabb> partial( 2*threadCount );
+    BoundsTask<Source> task = { &source, count, threadCount, &partial[0], 0, binCount, 0 };
+    runTasks( task, threadCount );
+
+    bounds.invalidate();
+    centroidBounds.invalidate();
+    for( unsigned int t = 0; t < threadCount; ++t ) {
+      bounds.include( partial[2*t] );
+      centroidBounds.include( partial[2*t+1] );
+    }
+
+    if( binCount == 0 )
+      return;
+    std::vector<unsigned int> counts( threadCount*3*binCount, 0u );
+    task.centroidBounds = &centroidBounds;
+    task.counts         = &counts[0];
+    runTasks( task, threadCount );
+    for( unsigned int i = 0; i < 3*binCount; ++i ) {
+      binCounts[i] = 0;
+      for( unsigned int t = 0; t < threadCount; ++t )
+        binCounts[i] += counts[t*3*binCount + i];
+    }
+  }
+  /** @endcond */
+
+  /** Computes the union of the bounds of triangleCount triangles and the bounds of their centroids, with the x, y and z
+  * of each triangle in one SIMD register, split across threadCount threads, or all hardware threads if threadCount is 0.
+  * Triangle i uses the vertices at indices[i], or vertices 3i, 3i+1 and 3i+2 if indices is 0, as in
+  * optix::prime::ModelObj::setTriangles. A centroid is the center of the triangle's Aabb.
+  *
+  * If binCount is not 0, a second pass fills binCounts with 3*binCount triangle counts: for each axis in turn, binCount
+  * equal-width bins across the centroid bounds. The results match Aabb::set and Aabb::include exactly and do not depend
+  * on the number of threads.
+  */
+  OPTIXU_INLINE void computeBounds( RTsize triangleCount, const int3* indices, RTsize vertexCount, const float3* vertices,
+                                    Aabb& bounds, Aabb& centroidBounds,
+                                    unsigned int binCount = 0, unsigned int* binCounts = 0, unsigned int threadCount = 0 )
+  {
+    const TriangleBoundsSource source = { vertices, indices, indices ? vertexCount : 3*triangleCount };
+    computeBounds( source, triangleCount, bounds, centroidBounds, binCount, binCounts, threadCount );
+  }
+
+  /** As computeBounds for triangles, for count boxes. */
+  OPTIXU_INLINE void computeBounds( RTsize count, const Aabb* boxes, Aabb& bounds, Aabb& centroidBounds,
+                                    unsigned int binCount = 0, unsigned int* binCounts = 0, unsigned int threadCount = 0 )
+  {
+    const BoxBoundsSource source = { boxes, count };
+    computeBounds( source, count, bounds, centroidBounds, binCount, binCounts, threadCount );
+  }
+
+} // end namespace optix
+
+#ifdef OPTIXU_INLINE_DEFINED
+#  undef OPTIXU_INLINE_DEFINED
+#  undef OPTIXU_INLINE
+#endif
+
+#undef OPTIXU_AABB_THREADS
+
+#endif // #if !defined(__CUDACC__)
+
+#endif // #ifndef __optixu_optixu_aabb_soa_namespace_h__
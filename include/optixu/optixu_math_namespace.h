@@ -117,6 +117,19 @@
 #  define OPTIXU_INLINE __forceinline__
 #endif // OPTIXU_INLINE 
 
+// Host code compiled as C++14 or later can use the vector constructors and arithmetic
+// operators in constant expressions, e.g. to build tables at compile time.  CUDA's own
+// make_float3( x, y, z ) and friends are not constexpr, so use aggregate initialization
+// such as float3 v = { x, y, z } for the components there.  Device code is unaffected.
+#ifndef OPTIXU_CONSTEXPR
+#  if !defined(__CUDACC__) && (__cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L))
+#    define OPTIXU_CONSTEXPR_ENABLED 1
+#    define OPTIXU_CONSTEXPR constexpr
+#  else
+#    define OPTIXU_CONSTEXPR
+#  endif
+#endif // OPTIXU_CONSTEXPR
+
 /******************************************************************************/
 namespace optix {
 #if defined(_WIN32) && !defined(RT_UINT_USHORT_DEFINED)
@@ -260,14 +273,14 @@ OPTIXU_INLINE float int_as_float(int i)
 /******************************************************************************/
 
 /** lerp */
-OPTIXU_INLINE RT_HOSTDEVICE float lerp(const float a, const float b, const float t)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float lerp(const float a, const float b, const float t)
 {
   return a + t*(b-a);
 }
 
 /** bilerp */
-OPTIXU_INLINE RT_HOSTDEVICE float bilerp(const float x00, const float x10, const float x01, const float x11,
-                                         const float u, const float v)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float bilerp(const float x00, const float x10, const float x01, const float x11,
+                                                          const float u, const float v)
 {
   return lerp( lerp( x00, x10, u ), lerp( x01, x11, u ), v );
 }
@@ -296,24 +309,28 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(float1& v, int i, float x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float2 make_float2(const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 make_float2(const float s)
 {
-  return make_float2(s, s);
+  float2 temp = { s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 make_float2(const int2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 make_float2(const int2& a)
 {
-  return make_float2(float(a.x), float(a.y));
+  float2 temp = { float(a.x), float(a.y) };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 make_float2(const uint2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 make_float2(const uint2& a)
 {
-  return make_float2(float(a.x), float(a.y));
+  float2 temp = { float(a.x), float(a.y) };
+  return temp;
 }
 /** @} */
 
 /** negate */
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator-(const float2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator-(const float2& a)
 {
-  return make_float2(-a.x, -a.y);
+  float2 temp = { -a.x, -a.y };
+  return temp;
 }
 
 /** min 
@@ -345,19 +362,22 @@ OPTIXU_INLINE RT_HOSTDEVICE float fmaxf(const float2& a)
 /** add 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator+(const float2& a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator+(const float2& a, const float2& b)
 {
-  return make_float2(a.x + b.x, a.y + b.y);
+  float2 temp = { a.x + b.x, a.y + b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator+(const float2& a, const float b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator+(const float2& a, const float b)
 {
-  return make_float2(a.x + b, a.y + b);
+  float2 temp = { a.x + b, a.y + b };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator+(const float a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator+(const float a, const float2& b)
 {
-  return make_float2(a + b.x, a + b.y);
+  float2 temp = { a + b.x, a + b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(float2& a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(float2& a, const float2& b)
 {
   a.x += b.x; a.y += b.y;
 }
@@ -366,19 +386,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(float2& a, const float2& b)
 /** subtract 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator-(const float2& a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator-(const float2& a, const float2& b)
 {
-  return make_float2(a.x - b.x, a.y - b.y);
+  float2 temp = { a.x - b.x, a.y - b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator-(const float2& a, const float b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator-(const float2& a, const float b)
 {
-  return make_float2(a.x - b, a.y - b);
+  float2 temp = { a.x - b, a.y - b };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator-(const float a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator-(const float a, const float2& b)
 {
-  return make_float2(a - b.x, a - b.y);
+  float2 temp = { a - b.x, a - b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(float2& a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(float2& a, const float2& b)
 {
   a.x -= b.x; a.y -= b.y;
 }
@@ -387,23 +410,26 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(float2& a, const float2& b)
 /** multiply 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator*(const float2& a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator*(const float2& a, const float2& b)
 {
-  return make_float2(a.x * b.x, a.y * b.y);
+  float2 temp = { a.x * b.x, a.y * b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator*(const float2& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator*(const float2& a, const float s)
 {
-  return make_float2(a.x * s, a.y * s);
+  float2 temp = { a.x * s, a.y * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator*(const float s, const float2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator*(const float s, const float2& a)
 {
-  return make_float2(a.x * s, a.y * s);
+  float2 temp = { a.x * s, a.y * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float2& a, const float2& s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(float2& a, const float2& s)
 {
   a.x *= s.x; a.y *= s.y;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float2& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(float2& a, const float s)
 {
   a.x *= s; a.y *= s;
 }
@@ -412,20 +438,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float2& a, const float s)
 /** divide 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator/(const float2& a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator/(const float2& a, const float2& b)
 {
-  return make_float2(a.x / b.x, a.y / b.y);
+  float2 temp = { a.x / b.x, a.y / b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator/(const float2& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator/(const float2& a, const float s)
 {
   float inv = 1.0f / s;
   return a * inv;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float2 operator/(const float s, const float2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 operator/(const float s, const float2& a)
 {
-  return make_float2( s/a.x, s/a.y );
+  float2 temp = { s/a.x, s/a.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator/=(float2& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator/=(float2& a, const float s)
 {
   float inv = 1.0f / s;
   a *= inv;
@@ -433,14 +461,14 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator/=(float2& a, const float s)
 /** @} */
 
 /** lerp */
-OPTIXU_INLINE RT_HOSTDEVICE float2 lerp(const float2& a, const float2& b, const float t)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 lerp(const float2& a, const float2& b, const float t)
 {
   return a + t*(b-a);
 }
 
 /** bilerp */
-OPTIXU_INLINE RT_HOSTDEVICE float2 bilerp(const float2& x00, const float2& x10, const float2& x01, const float2& x11,
-                                          const float u, const float v)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 bilerp(const float2& x00, const float2& x10, const float2& x01, const float2& x11,
+                                                           const float u, const float v)
 {
   return lerp( lerp( x00, x10, u ), lerp( x01, x11, u ), v );
 }
@@ -460,7 +488,7 @@ OPTIXU_INLINE RT_HOSTDEVICE float2 clamp(const float2& v, const float2& a, const
 /** @} */
 
 /** dot product */
-OPTIXU_INLINE RT_HOSTDEVICE float dot(const float2& a, const float2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float dot(const float2& a, const float2& b)
 {
   return a.x * b.x + a.y * b.y;
 }
@@ -524,28 +552,33 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(float2& v, int i, float x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float3 make_float3(const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 make_float3(const float s)
 {
-  return make_float3(s, s, s);
+  float3 temp = { s, s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 make_float3(const float2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 make_float3(const float2& a)
 {
-  return make_float3(a.x, a.y, 0.0f);
+  float3 temp = { a.x, a.y, 0.0f };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 make_float3(const int3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 make_float3(const int3& a)
 {
-  return make_float3(float(a.x), float(a.y), float(a.z));
+  float3 temp = { float(a.x), float(a.y), float(a.z) };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 make_float3(const uint3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 make_float3(const uint3& a)
 {
-  return make_float3(float(a.x), float(a.y), float(a.z));
+  float3 temp = { float(a.x), float(a.y), float(a.z) };
+  return temp;
 }
 /** @} */
 
 /** negate */
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator-(const float3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator-(const float3& a)
 {
-  return make_float3(-a.x, -a.y, -a.z);
+  float3 temp = { -a.x, -a.y, -a.z };
+  return temp;
 }
 
 /** min 
@@ -577,19 +610,22 @@ OPTIXU_INLINE RT_HOSTDEVICE float fmaxf(const float3& a)
 /** add 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator+(const float3& a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator+(const float3& a, const float3& b)
 {
-  return make_float3(a.x + b.x, a.y + b.y, a.z + b.z);
+  float3 temp = { a.x + b.x, a.y + b.y, a.z + b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator+(const float3& a, const float b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator+(const float3& a, const float b)
 {
-  return make_float3(a.x + b, a.y + b, a.z + b);
+  float3 temp = { a.x + b, a.y + b, a.z + b };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator+(const float a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator+(const float a, const float3& b)
 {
-  return make_float3(a + b.x, a + b.y, a + b.z);
+  float3 temp = { a + b.x, a + b.y, a + b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(float3& a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(float3& a, const float3& b)
 {
   a.x += b.x; a.y += b.y; a.z += b.z;
 }
@@ -598,19 +634,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(float3& a, const float3& b)
 /** subtract 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator-(const float3& a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator-(const float3& a, const float3& b)
 {
-  return make_float3(a.x - b.x, a.y - b.y, a.z - b.z);
+  float3 temp = { a.x - b.x, a.y - b.y, a.z - b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator-(const float3& a, const float b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator-(const float3& a, const float b)
 {
-  return make_float3(a.x - b, a.y - b, a.z - b);
+  float3 temp = { a.x - b, a.y - b, a.z - b };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator-(const float a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator-(const float a, const float3& b)
 {
-  return make_float3(a - b.x, a - b.y, a - b.z);
+  float3 temp = { a - b.x, a - b.y, a - b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(float3& a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(float3& a, const float3& b)
 {
   a.x -= b.x; a.y -= b.y; a.z -= b.z;
 }
@@ -619,23 +658,26 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(float3& a, const float3& b)
 /** multiply 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator*(const float3& a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator*(const float3& a, const float3& b)
 {
-  return make_float3(a.x * b.x, a.y * b.y, a.z * b.z);
+  float3 temp = { a.x * b.x, a.y * b.y, a.z * b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator*(const float3& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator*(const float3& a, const float s)
 {
-  return make_float3(a.x * s, a.y * s, a.z * s);
+  float3 temp = { a.x * s, a.y * s, a.z * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator*(const float s, const float3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator*(const float s, const float3& a)
 {
-  return make_float3(a.x * s, a.y * s, a.z * s);
+  float3 temp = { a.x * s, a.y * s, a.z * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float3& a, const float3& s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(float3& a, const float3& s)
 {
   a.x *= s.x; a.y *= s.y; a.z *= s.z;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float3& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(float3& a, const float s)
 {
   a.x *= s; a.y *= s; a.z *= s;
 }
@@ -644,20 +686,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float3& a, const float s)
 /** divide 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator/(const float3& a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator/(const float3& a, const float3& b)
 {
-  return make_float3(a.x / b.x, a.y / b.y, a.z / b.z);
+  float3 temp = { a.x / b.x, a.y / b.y, a.z / b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator/(const float3& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator/(const float3& a, const float s)
 {
   float inv = 1.0f / s;
   return a * inv;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float3 operator/(const float s, const float3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 operator/(const float s, const float3& a)
 {
-  return make_float3( s/a.x, s/a.y, s/a.z );
+  float3 temp = { s/a.x, s/a.y, s/a.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator/=(float3& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator/=(float3& a, const float s)
 {
   float inv = 1.0f / s;
   a *= inv;
@@ -665,14 +709,14 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator/=(float3& a, const float s)
 /** @} */
 
 /** lerp */
-OPTIXU_INLINE RT_HOSTDEVICE float3 lerp(const float3& a, const float3& b, const float t)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 lerp(const float3& a, const float3& b, const float t)
 {
   return a + t*(b-a);
 }
 
 /** bilerp */
-OPTIXU_INLINE RT_HOSTDEVICE float3 bilerp(const float3& x00, const float3& x10, const float3& x01, const float3& x11,
-                                          const float u, const float v)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 bilerp(const float3& x00, const float3& x10, const float3& x01, const float3& x11,
+                                                           const float u, const float v)
 {
   return lerp( lerp( x00, x10, u ), lerp( x01, x11, u ), v );
 }
@@ -692,15 +736,16 @@ OPTIXU_INLINE RT_HOSTDEVICE float3 clamp(const float3& v, const float3& a, const
 /** @} */
 
 /** dot product */
-OPTIXU_INLINE RT_HOSTDEVICE float dot(const float3& a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float dot(const float3& a, const float3& b)
 {
   return a.x * b.x + a.y * b.y + a.z * b.z;
 }
 
 /** cross product */
-OPTIXU_INLINE RT_HOSTDEVICE float3 cross(const float3& a, const float3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 cross(const float3& a, const float3& b)
 {
-  return make_float3(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x);
+  float3 temp = { a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x };
+  return temp;
 }
 
 /** length */
@@ -761,28 +806,33 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(float3& v, int i, float x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const float s)
 {
-  return make_float4(s, s, s, s);
+  float4 temp = { s, s, s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const float3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const float3& a)
 {
-  return make_float4(a.x, a.y, a.z, 0.0f);
+  float4 temp = { a.x, a.y, a.z, 0.0f };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const int4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const int4& a)
 {
-  return make_float4(float(a.x), float(a.y), float(a.z), float(a.w));
+  float4 temp = { float(a.x), float(a.y), float(a.z), float(a.w) };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const uint4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const uint4& a)
 {
-  return make_float4(float(a.x), float(a.y), float(a.z), float(a.w));
+  float4 temp = { float(a.x), float(a.y), float(a.z), float(a.w) };
+  return temp;
 }
 /** @} */
 
 /** negate */
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator-(const float4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator-(const float4& a)
 {
-  return make_float4(-a.x, -a.y, -a.z, -a.w);
+  float4 temp = { -a.x, -a.y, -a.z, -a.w };
+  return temp;
 }
 
 /** min 
@@ -814,19 +864,22 @@ OPTIXU_INLINE RT_HOSTDEVICE float fmaxf(const float4& a)
 /** add 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator+(const float4& a, const float4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator+(const float4& a, const float4& b)
 {
-  return make_float4(a.x + b.x, a.y + b.y, a.z + b.z,  a.w + b.w);
+  float4 temp = { a.x + b.x, a.y + b.y, a.z + b.z,  a.w + b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator+(const float4& a, const float b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator+(const float4& a, const float b)
 {
-  return make_float4(a.x + b, a.y + b, a.z + b,  a.w + b);
+  float4 temp = { a.x + b, a.y + b, a.z + b,  a.w + b };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator+(const float a, const float4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator+(const float a, const float4& b)
 {
-  return make_float4(a + b.x, a + b.y, a + b.z,  a + b.w);
+  float4 temp = { a + b.x, a + b.y, a + b.z,  a + b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(float4& a, const float4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(float4& a, const float4& b)
 {
   a.x += b.x; a.y += b.y; a.z += b.z; a.w += b.w;
 }
@@ -835,19 +888,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(float4& a, const float4& b)
 /** subtract 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator-(const float4& a, const float4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator-(const float4& a, const float4& b)
 {
-  return make_float4(a.x - b.x, a.y - b.y, a.z - b.z,  a.w - b.w);
+  float4 temp = { a.x - b.x, a.y - b.y, a.z - b.z,  a.w - b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator-(const float4& a, const float b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator-(const float4& a, const float b)
 {
-  return make_float4(a.x - b, a.y - b, a.z - b,  a.w - b);
+  float4 temp = { a.x - b, a.y - b, a.z - b,  a.w - b };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator-(const float a, const float4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator-(const float a, const float4& b)
 {
-  return make_float4(a - b.x, a - b.y, a - b.z,  a - b.w);
+  float4 temp = { a - b.x, a - b.y, a - b.z,  a - b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(float4& a, const float4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(float4& a, const float4& b)
 {
   a.x -= b.x; a.y -= b.y; a.z -= b.z; a.w -= b.w;
 }
@@ -856,23 +912,26 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(float4& a, const float4& b)
 /** multiply 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator*(const float4& a, const float4& s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator*(const float4& a, const float4& s)
 {
-  return make_float4(a.x * s.x, a.y * s.y, a.z * s.z, a.w * s.w);
+  float4 temp = { a.x * s.x, a.y * s.y, a.z * s.z, a.w * s.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator*(const float4& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator*(const float4& a, const float s)
 {
-  return make_float4(a.x * s, a.y * s, a.z * s, a.w * s);
+  float4 temp = { a.x * s, a.y * s, a.z * s, a.w * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator*(const float s, const float4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator*(const float s, const float4& a)
 {
-  return make_float4(a.x * s, a.y * s, a.z * s, a.w * s);
+  float4 temp = { a.x * s, a.y * s, a.z * s, a.w * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float4& a, const float4& s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(float4& a, const float4& s)
 {
   a.x *= s.x; a.y *= s.y; a.z *= s.z; a.w *= s.w;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float4& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(float4& a, const float s)
 {
   a.x *= s; a.y *= s; a.z *= s; a.w *= s;
 }
@@ -881,20 +940,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator*=(float4& a, const float s)
 /** divide 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator/(const float4& a, const float4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator/(const float4& a, const float4& b)
 {
-  return make_float4(a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w);
+  float4 temp = { a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator/(const float4& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator/(const float4& a, const float s)
 {
   float inv = 1.0f / s;
   return a * inv;
 }
-OPTIXU_INLINE RT_HOSTDEVICE float4 operator/(const float s, const float4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator/(const float s, const float4& a)
 {
-  return make_float4( s/a.x, s/a.y, s/a.z, s/a.w );
+  float4 temp = { s/a.x, s/a.y, s/a.z, s/a.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator/=(float4& a, const float s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator/=(float4& a, const float s)
 {
   float inv = 1.0f / s;
   a *= inv;
@@ -902,14 +963,14 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator/=(float4& a, const float s)
 /** @} */
 
 /** lerp */
-OPTIXU_INLINE RT_HOSTDEVICE float4 lerp(const float4& a, const float4& b, const float t)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 lerp(const float4& a, const float4& b, const float t)
 {
   return a + t*(b-a);
 }
 
 /** bilerp */
-OPTIXU_INLINE RT_HOSTDEVICE float4 bilerp(const float4& x00, const float4& x10, const float4& x01, const float4& x11,
-                                          const float u, const float v)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 bilerp(const float4& x00, const float4& x10, const float4& x01, const float4& x11,
+                                                           const float u, const float v)
 {
   return lerp( lerp( x00, x10, u ), lerp( x01, x11, u ), v );
 }
@@ -929,7 +990,7 @@ OPTIXU_INLINE RT_HOSTDEVICE float4 clamp(const float4& v, const float4& a, const
 /** @} */
 
 /** dot product */
-OPTIXU_INLINE RT_HOSTDEVICE float dot(const float4& a, const float4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float dot(const float4& a, const float4& b)
 {
   return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
 }
@@ -1017,20 +1078,23 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(int1& v, int i, int x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int2 make_int2(const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 make_int2(const int s)
 {
-  return make_int2(s, s);
+  int2 temp = { s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int2 make_int2(const float2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 make_int2(const float2& a)
 {
-  return make_int2(int(a.x), int(a.y));
+  int2 temp = { int(a.x), int(a.y) };
+  return temp;
 }
 /** @} */
 
 /** negate */
-OPTIXU_INLINE RT_HOSTDEVICE int2 operator-(const int2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 operator-(const int2& a)
 {
-  return make_int2(-a.x, -a.y);
+  int2 temp = { -a.x, -a.y };
+  return temp;
 }
 
 /** min */
@@ -1048,11 +1112,12 @@ OPTIXU_INLINE RT_HOSTDEVICE int2 max(const int2& a, const int2& b)
 /** add 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int2 operator+(const int2& a, const int2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 operator+(const int2& a, const int2& b)
 {
-  return make_int2(a.x + b.x, a.y + b.y);
+  int2 temp = { a.x + b.x, a.y + b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(int2& a, const int2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(int2& a, const int2& b)
 {
   a.x += b.x; a.y += b.y;
 }
@@ -1061,15 +1126,17 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(int2& a, const int2& b)
 /** subtract 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int2 operator-(const int2& a, const int2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 operator-(const int2& a, const int2& b)
 {
-  return make_int2(a.x - b.x, a.y - b.y);
+  int2 temp = { a.x - b.x, a.y - b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int2 operator-(const int2& a, const int b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 operator-(const int2& a, const int b)
 {
-  return make_int2(a.x - b, a.y - b);
+  int2 temp = { a.x - b, a.y - b };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(int2& a, const int2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(int2& a, const int2& b)
 {
   a.x -= b.x; a.y -= b.y;
 }
@@ -1078,19 +1145,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(int2& a, const int2& b)
 /** multiply 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int2 operator*(const int2& a, const int2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 operator*(const int2& a, const int2& b)
 {
-  return make_int2(a.x * b.x, a.y * b.y);
+  int2 temp = { a.x * b.x, a.y * b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int2 operator*(const int2& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 operator*(const int2& a, const int s)
 {
-  return make_int2(a.x * s, a.y * s);
+  int2 temp = { a.x * s, a.y * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int2 operator*(const int s, const int2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 operator*(const int s, const int2& a)
 {
-  return make_int2(a.x * s, a.y * s);
+  int2 temp = { a.x * s, a.y * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(int2& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(int2& a, const int s)
 {
   a.x *= s; a.y *= s;
 }
@@ -1113,12 +1183,12 @@ OPTIXU_INLINE RT_HOSTDEVICE int2 clamp(const int2& v, const int2& a, const int2&
 /** equality 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE bool operator==(const int2& a, const int2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator==(const int2& a, const int2& b)
 {
   return a.x == b.x && a.y == b.y;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE bool operator!=(const int2& a, const int2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator!=(const int2& a, const int2& b)
 {
   return a.x != b.x || a.y != b.y;
 }
@@ -1143,20 +1213,23 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(int2& v, int i, int x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int3 make_int3(const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 make_int3(const int s)
 {
-  return make_int3(s, s, s);
+  int3 temp = { s, s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int3 make_int3(const float3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 make_int3(const float3& a)
 {
-  return make_int3(int(a.x), int(a.y), int(a.z));
+  int3 temp = { int(a.x), int(a.y), int(a.z) };
+  return temp;
 }
 /** @} */
 
 /** negate */
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator-(const int3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator-(const int3& a)
 {
-  return make_int3(-a.x, -a.y, -a.z);
+  int3 temp = { -a.x, -a.y, -a.z };
+  return temp;
 }
 
 /** min */
@@ -1174,11 +1247,12 @@ OPTIXU_INLINE RT_HOSTDEVICE int3 max(const int3& a, const int3& b)
 /** add 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator+(const int3& a, const int3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator+(const int3& a, const int3& b)
 {
-  return make_int3(a.x + b.x, a.y + b.y, a.z + b.z);
+  int3 temp = { a.x + b.x, a.y + b.y, a.z + b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(int3& a, const int3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(int3& a, const int3& b)
 {
   a.x += b.x; a.y += b.y; a.z += b.z;
 }
@@ -1187,12 +1261,13 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(int3& a, const int3& b)
 /** subtract 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator-(const int3& a, const int3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator-(const int3& a, const int3& b)
 {
-  return make_int3(a.x - b.x, a.y - b.y, a.z - b.z);
+  int3 temp = { a.x - b.x, a.y - b.y, a.z - b.z };
+  return temp;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(int3& a, const int3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(int3& a, const int3& b)
 {
   a.x -= b.x; a.y -= b.y; a.z -= b.z;
 }
@@ -1201,19 +1276,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(int3& a, const int3& b)
 /** multiply 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator*(const int3& a, const int3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator*(const int3& a, const int3& b)
 {
-  return make_int3(a.x * b.x, a.y * b.y, a.z * b.z);
+  int3 temp = { a.x * b.x, a.y * b.y, a.z * b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator*(const int3& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator*(const int3& a, const int s)
 {
-  return make_int3(a.x * s, a.y * s, a.z * s);
+  int3 temp = { a.x * s, a.y * s, a.z * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator*(const int s, const int3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator*(const int s, const int3& a)
 {
-  return make_int3(a.x * s, a.y * s, a.z * s);
+  int3 temp = { a.x * s, a.y * s, a.z * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(int3& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(int3& a, const int s)
 {
   a.x *= s; a.y *= s; a.z *= s;
 }
@@ -1222,19 +1300,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator*=(int3& a, const int s)
 /** divide 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator/(const int3& a, const int3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator/(const int3& a, const int3& b)
 {
-  return make_int3(a.x / b.x, a.y / b.y, a.z / b.z);
+  int3 temp = { a.x / b.x, a.y / b.y, a.z / b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator/(const int3& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator/(const int3& a, const int s)
 {
-  return make_int3(a.x / s, a.y / s, a.z / s);
+  int3 temp = { a.x / s, a.y / s, a.z / s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int3 operator/(const int s, const int3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 operator/(const int s, const int3& a)
 {
-  return make_int3(s /a.x, s / a.y, s / a.z);
+  int3 temp = { s /a.x, s / a.y, s / a.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator/=(int3& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator/=(int3& a, const int s)
 {
   a.x /= s; a.y /= s; a.z /= s;
 }
@@ -1257,12 +1338,12 @@ OPTIXU_INLINE RT_HOSTDEVICE int3 clamp(const int3& v, const int3& a, const int3&
 /** equality 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE bool operator==(const int3& a, const int3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator==(const int3& a, const int3& b)
 {
   return a.x == b.x && a.y == b.y && a.z == b.z;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE bool operator!=(const int3& a, const int3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator!=(const int3& a, const int3& b)
 {
   return a.x != b.x || a.y != b.y || a.z != b.z;
 }
@@ -1287,20 +1368,23 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(int3& v, int i, int x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int4 make_int4(const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 make_int4(const int s)
 {
-  return make_int4(s, s, s, s);
+  int4 temp = { s, s, s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int4 make_int4(const float4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 make_int4(const float4& a)
 {
-  return make_int4((int)a.x, (int)a.y, (int)a.z, (int)a.w);
+  int4 temp = { (int)a.x, (int)a.y, (int)a.z, (int)a.w };
+  return temp;
 }
 /** @} */
 
 /** negate */
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator-(const int4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator-(const int4& a)
 {
-  return make_int4(-a.x, -a.y, -a.z, -a.w);
+  int4 temp = { -a.x, -a.y, -a.z, -a.w };
+  return temp;
 }
 
 /** min */
@@ -1318,11 +1402,12 @@ OPTIXU_INLINE RT_HOSTDEVICE int4 max(const int4& a, const int4& b)
 /** add 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator+(const int4& a, const int4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator+(const int4& a, const int4& b)
 {
-  return make_int4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+  int4 temp = { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(int4& a, const int4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(int4& a, const int4& b)
 {
   a.x += b.x; a.y += b.y; a.z += b.z; a.w += b.w;
 }
@@ -1331,12 +1416,13 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(int4& a, const int4& b)
 /** subtract 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator-(const int4& a, const int4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator-(const int4& a, const int4& b)
 {
-  return make_int4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+  int4 temp = { a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w };
+  return temp;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(int4& a, const int4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(int4& a, const int4& b)
 {
   a.x -= b.x; a.y -= b.y; a.z -= b.z; a.w -= b.w;
 }
@@ -1345,19 +1431,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(int4& a, const int4& b)
 /** multiply 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator*(const int4& a, const int4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator*(const int4& a, const int4& b)
 {
-  return make_int4(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
+  int4 temp = { a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator*(const int4& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator*(const int4& a, const int s)
 {
-  return make_int4(a.x * s, a.y * s, a.z * s, a.w * s);
+  int4 temp = { a.x * s, a.y * s, a.z * s, a.w * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator*(const int s, const int4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator*(const int s, const int4& a)
 {
-  return make_int4(a.x * s, a.y * s, a.z * s, a.w * s);
+  int4 temp = { a.x * s, a.y * s, a.z * s, a.w * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(int4& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(int4& a, const int s)
 {
   a.x *= s; a.y *= s; a.z *= s; a.w *= s;
 }
@@ -1366,19 +1455,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator*=(int4& a, const int s)
 /** divide 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator/(const int4& a, const int4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator/(const int4& a, const int4& b)
 {
-  return make_int4(a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w);
+  int4 temp = { a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator/(const int4& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator/(const int4& a, const int s)
 {
-  return make_int4(a.x / s, a.y / s, a.z / s, a.w / s);
+  int4 temp = { a.x / s, a.y / s, a.z / s, a.w / s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE int4 operator/(const int s, const int4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 operator/(const int s, const int4& a)
 {
-  return make_int4(s / a.x, s / a.y, s / a.z, s / a.w);
+  int4 temp = { s / a.x, s / a.y, s / a.z, s / a.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator/=(int4& a, const int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator/=(int4& a, const int s)
 {
   a.x /= s; a.y /= s; a.z /= s; a.w /= s;
 }
@@ -1401,12 +1493,12 @@ OPTIXU_INLINE RT_HOSTDEVICE int4 clamp(const int4& v, const int4& a, const int4&
 /** equality 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE bool operator==(const int4& a, const int4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator==(const int4& a, const int4& b)
 {
   return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE bool operator!=(const int4& a, const int4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator!=(const int4& a, const int4& b)
 {
   return a.x != b.x || a.y != b.y || a.z != b.z || a.w != b.w;
 }
@@ -1453,13 +1545,15 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(uint1& v, int i, unsigned int x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint2 make_uint2(const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 make_uint2(const unsigned int s)
 {
-  return make_uint2(s, s);
+  uint2 temp = { s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint2 make_uint2(const float2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 make_uint2(const float2& a)
 {
-  return make_uint2((unsigned int)a.x, (unsigned int)a.y);
+  uint2 temp = { (unsigned int)a.x, (unsigned int)a.y };
+  return temp;
 }
 /** @} */
 
@@ -1478,11 +1572,12 @@ OPTIXU_INLINE RT_HOSTDEVICE uint2 max(const uint2& a, const uint2& b)
 /** add
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint2 operator+(const uint2& a, const uint2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 operator+(const uint2& a, const uint2& b)
 {
-  return make_uint2(a.x + b.x, a.y + b.y);
+  uint2 temp = { a.x + b.x, a.y + b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(uint2& a, const uint2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(uint2& a, const uint2& b)
 {
   a.x += b.x; a.y += b.y;
 }
@@ -1491,15 +1586,17 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(uint2& a, const uint2& b)
 /** subtract
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint2 operator-(const uint2& a, const uint2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 operator-(const uint2& a, const uint2& b)
 {
-  return make_uint2(a.x - b.x, a.y - b.y);
+  uint2 temp = { a.x - b.x, a.y - b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint2 operator-(const uint2& a, const unsigned int b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 operator-(const uint2& a, const unsigned int b)
 {
-  return make_uint2(a.x - b, a.y - b);
+  uint2 temp = { a.x - b, a.y - b };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(uint2& a, const uint2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(uint2& a, const uint2& b)
 {
   a.x -= b.x; a.y -= b.y;
 }
@@ -1508,19 +1605,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(uint2& a, const uint2& b)
 /** multiply
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint2 operator*(const uint2& a, const uint2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 operator*(const uint2& a, const uint2& b)
 {
-  return make_uint2(a.x * b.x, a.y * b.y);
+  uint2 temp = { a.x * b.x, a.y * b.y };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint2 operator*(const uint2& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 operator*(const uint2& a, const unsigned int s)
 {
-  return make_uint2(a.x * s, a.y * s);
+  uint2 temp = { a.x * s, a.y * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint2 operator*(const unsigned int s, const uint2& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 operator*(const unsigned int s, const uint2& a)
 {
-  return make_uint2(a.x * s, a.y * s);
+  uint2 temp = { a.x * s, a.y * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(uint2& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(uint2& a, const unsigned int s)
 {
   a.x *= s; a.y *= s;
 }
@@ -1543,12 +1643,12 @@ OPTIXU_INLINE RT_HOSTDEVICE uint2 clamp(const uint2& v, const uint2& a, const ui
 /** equality
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE bool operator==(const uint2& a, const uint2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator==(const uint2& a, const uint2& b)
 {
   return a.x == b.x && a.y == b.y;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE bool operator!=(const uint2& a, const uint2& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator!=(const uint2& a, const uint2& b)
 {
   return a.x != b.x || a.y != b.y;
 }
@@ -1573,13 +1673,15 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(uint2& v, int i, unsigned int x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint3 make_uint3(const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 make_uint3(const unsigned int s)
 {
-  return make_uint3(s, s, s);
+  uint3 temp = { s, s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint3 make_uint3(const float3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 make_uint3(const float3& a)
 {
-  return make_uint3((unsigned int)a.x, (unsigned int)a.y, (unsigned int)a.z);
+  uint3 temp = { (unsigned int)a.x, (unsigned int)a.y, (unsigned int)a.z };
+  return temp;
 }
 /** @} */
 
@@ -1598,11 +1700,12 @@ OPTIXU_INLINE RT_HOSTDEVICE uint3 max(const uint3& a, const uint3& b)
 /** add 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint3 operator+(const uint3& a, const uint3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 operator+(const uint3& a, const uint3& b)
 {
-  return make_uint3(a.x + b.x, a.y + b.y, a.z + b.z);
+  uint3 temp = { a.x + b.x, a.y + b.y, a.z + b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(uint3& a, const uint3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(uint3& a, const uint3& b)
 {
   a.x += b.x; a.y += b.y; a.z += b.z;
 }
@@ -1611,12 +1714,13 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(uint3& a, const uint3& b)
 /** subtract
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint3 operator-(const uint3& a, const uint3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 operator-(const uint3& a, const uint3& b)
 {
-  return make_uint3(a.x - b.x, a.y - b.y, a.z - b.z);
+  uint3 temp = { a.x - b.x, a.y - b.y, a.z - b.z };
+  return temp;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(uint3& a, const uint3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(uint3& a, const uint3& b)
 {
   a.x -= b.x; a.y -= b.y; a.z -= b.z;
 }
@@ -1625,19 +1729,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(uint3& a, const uint3& b)
 /** multiply
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint3 operator*(const uint3& a, const uint3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 operator*(const uint3& a, const uint3& b)
 {
-  return make_uint3(a.x * b.x, a.y * b.y, a.z * b.z);
+  uint3 temp = { a.x * b.x, a.y * b.y, a.z * b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint3 operator*(const uint3& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 operator*(const uint3& a, const unsigned int s)
 {
-  return make_uint3(a.x * s, a.y * s, a.z * s);
+  uint3 temp = { a.x * s, a.y * s, a.z * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint3 operator*(const unsigned int s, const uint3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 operator*(const unsigned int s, const uint3& a)
 {
-  return make_uint3(a.x * s, a.y * s, a.z * s);
+  uint3 temp = { a.x * s, a.y * s, a.z * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(uint3& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(uint3& a, const unsigned int s)
 {
   a.x *= s; a.y *= s; a.z *= s;
 }
@@ -1646,19 +1753,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator*=(uint3& a, const unsigned int s)
 /** divide
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint3 operator/(const uint3& a, const uint3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 operator/(const uint3& a, const uint3& b)
 {
-  return make_uint3(a.x / b.x, a.y / b.y, a.z / b.z);
+  uint3 temp = { a.x / b.x, a.y / b.y, a.z / b.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint3 operator/(const uint3& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 operator/(const uint3& a, const unsigned int s)
 {
-  return make_uint3(a.x / s, a.y / s, a.z / s);
+  uint3 temp = { a.x / s, a.y / s, a.z / s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint3 operator/(const unsigned int s, const uint3& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 operator/(const unsigned int s, const uint3& a)
 {
-  return make_uint3(s / a.x, s / a.y, s / a.z);
+  uint3 temp = { s / a.x, s / a.y, s / a.z };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator/=(uint3& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator/=(uint3& a, const unsigned int s)
 {
   a.x /= s; a.y /= s; a.z /= s;
 }
@@ -1681,12 +1791,12 @@ OPTIXU_INLINE RT_HOSTDEVICE uint3 clamp(const uint3& v, const uint3& a, const ui
 /** equality 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE bool operator==(const uint3& a, const uint3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator==(const uint3& a, const uint3& b)
 {
   return a.x == b.x && a.y == b.y && a.z == b.z;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE bool operator!=(const uint3& a, const uint3& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator!=(const uint3& a, const uint3& b)
 {
   return a.x != b.x || a.y != b.y || a.z != b.z;
 }
@@ -1713,13 +1823,15 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(uint3& v, int i, unsigned int x)
 /** additional constructors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint4 make_uint4(const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 make_uint4(const unsigned int s)
 {
-  return make_uint4(s, s, s, s);
+  uint4 temp = { s, s, s, s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 make_uint4(const float4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 make_uint4(const float4& a)
 {
-  return make_uint4((unsigned int)a.x, (unsigned int)a.y, (unsigned int)a.z, (unsigned int)a.w);
+  uint4 temp = { (unsigned int)a.x, (unsigned int)a.y, (unsigned int)a.z, (unsigned int)a.w };
+  return temp;
 }
 /** @} */
 
@@ -1744,11 +1856,12 @@ OPTIXU_INLINE RT_HOSTDEVICE uint4 max(const uint4& a, const uint4& b)
 /** add
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint4 operator+(const uint4& a, const uint4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 operator+(const uint4& a, const uint4& b)
 {
-  return make_uint4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+  uint4 temp = { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator+=(uint4& a, const uint4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator+=(uint4& a, const uint4& b)
 {
   a.x += b.x; a.y += b.y; a.z += b.z; a.w += b.w;
 }
@@ -1757,12 +1870,13 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator+=(uint4& a, const uint4& b)
 /** subtract 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint4 operator-(const uint4& a, const uint4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 operator-(const uint4& a, const uint4& b)
 {
-  return make_uint4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+  uint4 temp = { a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w };
+  return temp;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE void operator-=(uint4& a, const uint4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator-=(uint4& a, const uint4& b)
 {
   a.x -= b.x; a.y -= b.y; a.z -= b.z; a.w -= b.w;
 }
@@ -1771,19 +1885,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator-=(uint4& a, const uint4& b)
 /** multiply
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint4 operator*(const uint4& a, const uint4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 operator*(const uint4& a, const uint4& b)
 {
-  return make_uint4(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
+  uint4 temp = { a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 operator*(const uint4& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 operator*(const uint4& a, const unsigned int s)
 {
-  return make_uint4(a.x * s, a.y * s, a.z * s, a.w * s);
+  uint4 temp = { a.x * s, a.y * s, a.z * s, a.w * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 operator*(const unsigned int s, const uint4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 operator*(const unsigned int s, const uint4& a)
 {
-  return make_uint4(a.x * s, a.y * s, a.z * s, a.w * s);
+  uint4 temp = { a.x * s, a.y * s, a.z * s, a.w * s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator*=(uint4& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator*=(uint4& a, const unsigned int s)
 {
   a.x *= s; a.y *= s; a.z *= s; a.w *= s;
 }
@@ -1792,19 +1909,22 @@ OPTIXU_INLINE RT_HOSTDEVICE void operator*=(uint4& a, const unsigned int s)
 /** divide 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE uint4 operator/(const uint4& a, const uint4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 operator/(const uint4& a, const uint4& b)
 {
-  return make_uint4(a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w);
+  uint4 temp = { a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 operator/(const uint4& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 operator/(const uint4& a, const unsigned int s)
 {
-  return make_uint4(a.x / s, a.y / s, a.z / s, a.w / s);
+  uint4 temp = { a.x / s, a.y / s, a.z / s, a.w / s };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 operator/(const unsigned int s, const uint4& a)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 operator/(const unsigned int s, const uint4& a)
 {
-  return make_uint4(s / a.x, s / a.y, s / a.z, s / a.w);
+  uint4 temp = { s / a.x, s / a.y, s / a.z, s / a.w };
+  return temp;
 }
-OPTIXU_INLINE RT_HOSTDEVICE void operator/=(uint4& a, const unsigned int s)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR void operator/=(uint4& a, const unsigned int s)
 {
   a.x /= s; a.y /= s; a.z /= s; a.w /= s;
 }
@@ -1827,12 +1947,12 @@ OPTIXU_INLINE RT_HOSTDEVICE uint4 clamp(const uint4& v, const uint4& a, const ui
 /** equality 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE bool operator==(const uint4& a, const uint4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator==(const uint4& a, const uint4& b)
 {
   return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
 }
 
-OPTIXU_INLINE RT_HOSTDEVICE bool operator!=(const uint4& a, const uint4& b)
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR bool operator!=(const uint4& a, const uint4& b)
 {
   return a.x != b.x || a.y != b.y || a.z != b.z || a.w != b.w;
 }
@@ -1858,44 +1978,44 @@ OPTIXU_INLINE RT_HOSTDEVICE void setByIndex(uint4& v, int i, unsigned int x)
 /** Narrowing functions
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int2 make_int2(const int3& v0) { return make_int2( v0.x, v0.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE int2 make_int2(const int4& v0) { return make_int2( v0.x, v0.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE int3 make_int3(const int4& v0) { return make_int3( v0.x, v0.y, v0.z ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint2 make_uint2(const uint3& v0) { return make_uint2( v0.x, v0.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint2 make_uint2(const uint4& v0) { return make_uint2( v0.x, v0.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint3 make_uint3(const uint4& v0) { return make_uint3( v0.x, v0.y, v0.z ); }
-OPTIXU_INLINE RT_HOSTDEVICE float2 make_float2(const float3& v0) { return make_float2( v0.x, v0.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE float2 make_float2(const float4& v0) { return make_float2( v0.x, v0.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE float3 make_float3(const float4& v0) { return make_float3( v0.x, v0.y, v0.z ); }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 make_int2(const int3& v0) { int2 temp = { v0.x, v0.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int2 make_int2(const int4& v0) { int2 temp = { v0.x, v0.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 make_int3(const int4& v0) { int3 temp = { v0.x, v0.y, v0.z }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 make_uint2(const uint3& v0) { uint2 temp = { v0.x, v0.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint2 make_uint2(const uint4& v0) { uint2 temp = { v0.x, v0.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 make_uint3(const uint4& v0) { uint3 temp = { v0.x, v0.y, v0.z }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 make_float2(const float3& v0) { float2 temp = { v0.x, v0.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float2 make_float2(const float4& v0) { float2 temp = { v0.x, v0.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 make_float3(const float4& v0) { float3 temp = { v0.x, v0.y, v0.z }; return temp; }
 /** @} */
 
 /** Assemble functions from smaller vectors 
 * @{
 */
-OPTIXU_INLINE RT_HOSTDEVICE int3 make_int3(const int v0, const int2& v1) { return make_int3( v0, v1.x, v1.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE int3 make_int3(const int2& v0, const int v1) { return make_int3( v0.x, v0.y, v1 ); }
-OPTIXU_INLINE RT_HOSTDEVICE int4 make_int4(const int v0, const int v1, const int2& v2) { return make_int4( v0, v1, v2.x, v2.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE int4 make_int4(const int v0, const int2& v1, const int v2) { return make_int4( v0, v1.x, v1.y, v2 ); }
-OPTIXU_INLINE RT_HOSTDEVICE int4 make_int4(const int2& v0, const int v1, const int v2) { return make_int4( v0.x, v0.y, v1, v2 ); }
-OPTIXU_INLINE RT_HOSTDEVICE int4 make_int4(const int v0, const int3& v1) { return make_int4( v0, v1.x, v1.y, v1.z ); }
-OPTIXU_INLINE RT_HOSTDEVICE int4 make_int4(const int3& v0, const int v1) { return make_int4( v0.x, v0.y, v0.z, v1 ); }
-OPTIXU_INLINE RT_HOSTDEVICE int4 make_int4(const int2& v0, const int2& v1) { return make_int4( v0.x, v0.y, v1.x, v1.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint3 make_uint3(const unsigned int v0, const uint2& v1) { return make_uint3( v0, v1.x, v1.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint3 make_uint3(const uint2& v0, const unsigned int v1) { return make_uint3( v0.x, v0.y, v1 ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 make_uint4(const unsigned int v0, const unsigned int v1, const uint2& v2) { return make_uint4( v0, v1, v2.x, v2.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 make_uint4(const unsigned int v0, const uint2& v1, const unsigned int v2) { return make_uint4( v0, v1.x, v1.y, v2 ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 make_uint4(const uint2& v0, const unsigned int v1, const unsigned int v2) { return make_uint4( v0.x, v0.y, v1, v2 ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 make_uint4(const unsigned int v0, const uint3& v1) { return make_uint4( v0, v1.x, v1.y, v1.z ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 make_uint4(const uint3& v0, const unsigned int v1) { return make_uint4( v0.x, v0.y, v0.z, v1 ); }
-OPTIXU_INLINE RT_HOSTDEVICE uint4 make_uint4(const uint2& v0, const uint2& v1) { return make_uint4( v0.x, v0.y, v1.x, v1.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE float3 make_float3(const float2& v0, const float v1) { return make_float3(v0.x, v0.y, v1); }
-OPTIXU_INLINE RT_HOSTDEVICE float3 make_float3(const float v0, const float2& v1) { return make_float3( v0, v1.x, v1.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const float v0, const float v1, const float2& v2) { return make_float4( v0, v1, v2.x, v2.y ); }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const float v0, const float2& v1, const float v2) { return make_float4( v0, v1.x, v1.y, v2 ); }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const float2& v0, const float v1, const float v2) { return make_float4( v0.x, v0.y, v1, v2 ); }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const float v0, const float3& v1) { return make_float4( v0, v1.x, v1.y, v1.z ); }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const float3& v0, const float v1) { return make_float4( v0.x, v0.y, v0.z, v1 ); }
-OPTIXU_INLINE RT_HOSTDEVICE float4 make_float4(const float2& v0, const float2& v1) { return make_float4( v0.x, v0.y, v1.x, v1.y ); }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 make_int3(const int v0, const int2& v1) { int3 temp = { v0, v1.x, v1.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int3 make_int3(const int2& v0, const int v1) { int3 temp = { v0.x, v0.y, v1 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 make_int4(const int v0, const int v1, const int2& v2) { int4 temp = { v0, v1, v2.x, v2.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 make_int4(const int v0, const int2& v1, const int v2) { int4 temp = { v0, v1.x, v1.y, v2 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 make_int4(const int2& v0, const int v1, const int v2) { int4 temp = { v0.x, v0.y, v1, v2 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 make_int4(const int v0, const int3& v1) { int4 temp = { v0, v1.x, v1.y, v1.z }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 make_int4(const int3& v0, const int v1) { int4 temp = { v0.x, v0.y, v0.z, v1 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR int4 make_int4(const int2& v0, const int2& v1) { int4 temp = { v0.x, v0.y, v1.x, v1.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 make_uint3(const unsigned int v0, const uint2& v1) { uint3 temp = { v0, v1.x, v1.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint3 make_uint3(const uint2& v0, const unsigned int v1) { uint3 temp = { v0.x, v0.y, v1 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 make_uint4(const unsigned int v0, const unsigned int v1, const uint2& v2) { uint4 temp = { v0, v1, v2.x, v2.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 make_uint4(const unsigned int v0, const uint2& v1, const unsigned int v2) { uint4 temp = { v0, v1.x, v1.y, v2 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 make_uint4(const uint2& v0, const unsigned int v1, const unsigned int v2) { uint4 temp = { v0.x, v0.y, v1, v2 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 make_uint4(const unsigned int v0, const uint3& v1) { uint4 temp = { v0, v1.x, v1.y, v1.z }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 make_uint4(const uint3& v0, const unsigned int v1) { uint4 temp = { v0.x, v0.y, v0.z, v1 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR uint4 make_uint4(const uint2& v0, const uint2& v1) { uint4 temp = { v0.x, v0.y, v1.x, v1.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 make_float3(const float2& v0, const float v1) { float3 temp = { v0.x, v0.y, v1 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float3 make_float3(const float v0, const float2& v1) { float3 temp = { v0, v1.x, v1.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const float v0, const float v1, const float2& v2) { float4 temp = { v0, v1, v2.x, v2.y }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const float v0, const float2& v1, const float v2) { float4 temp = { v0, v1.x, v1.y, v2 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const float2& v0, const float v1, const float v2) { float4 temp = { v0.x, v0.y, v1, v2 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const float v0, const float3& v1) { float4 temp = { v0, v1.x, v1.y, v1.z }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const float3& v0, const float v1) { float4 temp = { v0.x, v0.y, v0.z, v1 }; return temp; }
+OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 make_float4(const float2& v0, const float2& v1) { float4 temp = { v0.x, v0.y, v1.x, v1.y }; return temp; }
 /** @} */
 
 
@@ -1988,6 +2108,125 @@ OPTIXU_INLINE RT_HOSTDEVICE bool intersect_triangle_earlyexit(const Ray&    ray,
   return false;
 }
 
+/** Per-ray constants of the watertight triangle intersection.  Compute them once
+*   with make_watertight_ray when the same ray is tested against many triangles.
+*/
+struct WatertightRay
+{
+  int   kx, ky, kz;   /** Ray direction axes, kz being the dominant one */
+  float sx, sy, sz;   /** Shear and scale transforming the ray direction to +z */
+};
+
+OPTIXU_INLINE RT_HOSTDEVICE WatertightRay make_watertight_ray(const Ray& ray)
+{
+  const float3 d = make_float3( fabsf(ray.direction.x), fabsf(ray.direction.y), fabsf(ray.direction.z) );
+  WatertightRay wr;
+  wr.kz = d.x > d.y ? ( d.x > d.z ? 0 : 2 ) : ( d.y > d.z ? 1 : 2 );
+  wr.kx = wr.kz == 2 ? 0 : wr.kz + 1;
+  wr.ky = wr.kx == 2 ? 0 : wr.kx + 1;
+
+  // Swap kx and ky to preserve the winding direction of triangles
+  const float* dir = reinterpret_cast<const float*>( &ray.direction );
+  if( dir[wr.kz] < 0.0f ) {
+    const int k = wr.kx;
+    wr.kx = wr.ky;
+    wr.ky = k;
+  }
+
+  wr.sz = 1.0f / dir[wr.kz];
+  wr.sx = dir[wr.kx] * wr.sz;
+  wr.sy = dir[wr.ky] * wr.sz;
+  return wr;
+}
+
+/** @cond */
+/* a*b - c*d, rounded the same whether or not the compiler contracts it into an FMA.  The
+*  watertight test relies on this: a vertex shared by two triangles must shear to the same
+*  point in both, and a shared edge must give exactly opposite edge functions.
+*/
+OPTIXU_INLINE RT_HOSTDEVICE float watertight_difference_of_products(float a, float b, float c, float d)
+{
+#if defined(__CUDA_ARCH__)
+  // The _rn intrinsics are never contracted
+  return __fsub_rn( __fmul_rn(a, b), __fmul_rn(c, d) );
+#else
+  // Products of floats are exact in double, so an FMA rounds the same as a multiply and a subtract
+  return (float)( (double)a*(double)b - (double)c*(double)d );
+#endif
+}
+/** @endcond */
+
+/** Watertight intersection (Woop, Benthin and Wald 2013).  Rays through an edge or
+*   vertex shared by several triangles hit at least one of them, also when the compiler
+*   contracts multiplies and adds into FMAs.  n, t, beta and gamma have the same meaning
+*   as for intersect_triangle_branchless, but are computed differently, so their values
+*   can differ in the last bits.
+*/
+OPTIXU_INLINE RT_HOSTDEVICE bool intersect_triangle_watertight(const Ray&           ray,
+                                                               const WatertightRay& wr,
+                                                               const float3&        p0,
+                                                               const float3&        p1,
+                                                               const float3&        p2,
+                                                                     float3&        n,
+                                                                     float&         t,
+                                                                     float&         beta,
+                                                                     float&         gamma)
+{
+  const float3 a = p0 - ray.origin;
+  const float3 b = p1 - ray.origin;
+  const float3 c = p2 - ray.origin;
+  const float* A = reinterpret_cast<const float*>( &a );
+  const float* B = reinterpret_cast<const float*>( &b );
+  const float* C = reinterpret_cast<const float*>( &c );
+
+  // Shear the vertices into the ray's space, where the ray starts at the origin and points along +z
+  const float ax = watertight_difference_of_products( A[wr.kx], 1.0f, wr.sx, A[wr.kz] );
+  const float ay = watertight_difference_of_products( A[wr.ky], 1.0f, wr.sy, A[wr.kz] );
+  const float bx = watertight_difference_of_products( B[wr.kx], 1.0f, wr.sx, B[wr.kz] );
+  const float by = watertight_difference_of_products( B[wr.ky], 1.0f, wr.sy, B[wr.kz] );
+  const float cx = watertight_difference_of_products( C[wr.kx], 1.0f, wr.sx, C[wr.kz] );
+  const float cy = watertight_difference_of_products( C[wr.ky], 1.0f, wr.sy, C[wr.kz] );
+
+  // Scaled barycentric coordinates
+  float u = watertight_difference_of_products( cx, by, cy, bx );
+  float v = watertight_difference_of_products( ax, cy, ay, cx );
+  float w = watertight_difference_of_products( bx, ay, by, ax );
+#if defined(__CUDA_ARCH__)
+  // Rounded in float on the device, so recompute in double precision when a ray grazes an edge
+  if( u == 0.0f || v == 0.0f || w == 0.0f ) {
+    u = (float)( (double)cx*(double)by - (double)cy*(double)bx );
+    v = (float)( (double)ax*(double)cy - (double)ay*(double)cx );
+    w = (float)( (double)bx*(double)ay - (double)by*(double)ax );
+  }
+#endif
+
+  const float det = u + v + w;
+  const float tscaled = wr.sz * ( u*A[wr.kz] + v*B[wr.kz] + w*C[wr.kz] );
+  const float rcp = 1.0f / det;
+
+  n     = cross( p0 - p2, p1 - p0 );
+  t     = tscaled * rcp;
+  beta  = v * rcp;
+  gamma = w * rcp;
+
+  const bool inside = ( (u>=0.0f) & (v>=0.0f) & (w>=0.0f) ) | ( (u<=0.0f) & (v<=0.0f) & (w<=0.0f) );
+  return ( inside & (det!=0.0f) & (t<ray.tmax) & (t>ray.tmin) );
+}
+
+/** Watertight intersection, computing the per-ray constants on the fly.
+*/
+OPTIXU_INLINE RT_HOSTDEVICE bool intersect_triangle_watertight(const Ray&    ray,
+                                                               const float3& p0,
+                                                               const float3& p1,
+                                                               const float3& p2,
+                                                                     float3& n,
+                                                                     float&  t,
+                                                                     float&  beta,
+                                                                     float&  gamma)
+{
+  return intersect_triangle_watertight(ray, make_watertight_ray(ray), p0, p1, p2, n, t, beta, gamma);
+}
+
 /** Intersect ray with CCW wound triangle.  Returns non-normalize normal vector. */ 
 OPTIXU_INLINE RT_HOSTDEVICE bool intersect_triangle(const Ray&    ray,
                                                     const float3& p0,
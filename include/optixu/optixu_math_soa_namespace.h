@@ -0,0 +1,883 @@
+
+/*
+ * Copyright (c) 2008 - 2010 NVIDIA Corporation.  All rights reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property and proprietary
+ * rights in and to this software, related documentation and any modifications thereto.
+ * Any use, reproduction, disclosure or distribution of this software and related
+ * documentation without an express license agreement from NVIDIA Corporation is strictly
+ * prohibited.
+ *
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, THIS SOFTWARE IS PROVIDED *AS IS*
+ * AND NVIDIA AND ITS SUPPLIERS DISCLAIM ALL WARRANTIES, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE.  IN NO EVENT SHALL NVIDIA OR ITS SUPPLIERS BE LIABLE FOR ANY
+ * SPECIAL, INCIDENTAL, INDIRECT, OR CONSEQUENTIAL DAMAGES WHATSOEVER (INCLUDING, WITHOUT
+ * LIMITATION, DAMAGES FOR LOSS OF BUSINESS PROFITS, BUSINESS INTERRUPTION, LOSS OF
+ * BUSINESS INFORMATION, OR ANY OTHER PECUNIARY LOSS) ARISING OUT OF THE USE OF OR
+ * INABILITY TO USE THIS SOFTWARE, EVEN IF NVIDIA HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES
+ */
+
+ /**
+ * @file   optixu_math_soa_namespace.h
+ * @author NVIDIA Corporation
+ * @brief  OptiX public API
+ *
+ * Structure-of-arrays packets of 4 and 8 floats and float3s for host code, with the
+ * operators and functions of optixu_math_namespace.h applied lane by lane, and blocks of
+ * 4 and 8 triangles for intersect_triangles_branchless and intersect_triangles_watertight.
+ *
+ * floatx4 maps to SSE registers and floatx8 to AVX registers when the compiler targets
+ * them, otherwise (including AArch64) to plain arrays. Define OPTIXU_SOA_SCALAR to force
+ * the scalar versions. With AVX, floatx8, float3x8, Trianglesx8 and WatertightTrianglesx8
+ * need 32 byte alignment, which new and std::vector do not guarantee before C++17.
+ */
+
+#ifndef __optixu_optixu_math_soa_namespace_h__
+#define __optixu_optixu_math_soa_namespace_h__
+
+#include "optixu_math_namespace.h"
+
+#if !defined(__CUDACC__)
+
+#if !defined(OPTIXU_SOA_SCALAR)
+#  if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#    define OPTIXU_SOA_SSE 1
+#    include <xmmintrin.h>
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#      define OPTIXU_SOA_SSE2 1
+#      include <emmintrin.h>
+#    endif
+#    if defined(__AVX__)
+#      define OPTIXU_SOA_AVX 1
+#      include <immintrin.h>
+#    endif
+#  endif
+#endif
+
+// __forceinline__ works in cuda, VS, and with gcc.  Leave it as macro in case
+// we need to make this per-platform or we want to switch off inlining globally.
+#ifndef OPTIXU_INLINE
+#  define OPTIXU_INLINE_DEFINED 1
+#  define OPTIXU_INLINE __forceinline__
+#endif // OPTIXU_INLINE
+
+namespace optix {
+
+  // Keep the float version visible next to the packet overloads below
+  using ::sqrtf;
+
+/* floatx4 functions */
+/******************************************************************************/
+
+/** Four floats, one per lane */
+struct floatx4
+{
+#if defined(OPTIXU_SOA_SSE)
+  __m128 v;
+#else
+  float v[4];
+#endif
+};
+
+/** Loads lanes from 4 consecutive floats, which need not be aligned */
+OPTIXU_INLINE floatx4 loadx4(const float* p)
+{
+  floatx4 r;
+#if defined(OPTIXU_SOA_SSE)
+  r.v = _mm_loadu_ps(p);
+#else
+  r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3];
+#endif
+  return r;
+}
+
+/** constructors
+* @{
+*/
+OPTIXU_INLINE floatx4 make_floatx4(const float s)
+{
+  floatx4 r;
+#if defined(OPTIXU_SOA_SSE)
+  r.v = _mm_set1_ps(s);
+#else
+  r.v[0] = r.v[1] = r.v[2] = r.v[3] = s;
+#endif
+  return r;
+}
+OPTIXU_INLINE floatx4 make_floatx4(const float a, const float b, const float c, const float d)
+{
+  floatx4 r;
+#if defined(OPTIXU_SOA_SSE)
+  r.v = _mm_setr_ps(a, b, c, d);
+#else
+  const float v[4] = { a, b, c, d };
+  r = loadx4(v);
+#endif
+  return r;
+}
+/** @} */
+
+/** Stores lanes to 4 consecutive floats, which need not be aligned */
+OPTIXU_INLINE void store(float* p, const floatx4& a)
+{
+#if defined(OPTIXU_SOA_SSE)
+  _mm_storeu_ps(p, a.v);
+#else
+  p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+#endif
+}
+
+/** @cond */
+// Transposes 4 consecutive float3s at p into x, y and z lanes, in registers where the backend allows
+OPTIXU_INLINE void soa_load3(const float* p, floatx4& x, floatx4& y, floatx4& z)
+{
+#if defined(OPTIXU_SOA_SSE)
+  // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+  const __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8);
+  x.v = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,3,0));
+  y.v = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+  z.v = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)), c, _MM_SHUFFLE(3,0,2,0));
+#else
+  for(int i = 0; i < 4; ++i) { x.v[i] = p[3*i]; y.v[i] = p[3*i+1]; z.v[i] = p[3*i+2]; }
+#endif
+}
+
+// Inverse of soa_load3
+OPTIXU_INLINE void soa_store3(float* p, const floatx4& x, const floatx4& y, const floatx4& z)
+{
+#if defined(OPTIXU_SOA_SSE)
+  const __m128 xy = _mm_shuffle_ps(x.v, y.v, _MM_SHUFFLE(0,0,0,0));   // x0 x0 y0 y0
+  const __m128 zx = _mm_shuffle_ps(z.v, x.v, _MM_SHUFFLE(1,1,0,0));   // z0 z0 x1 x1
+  const __m128 yz = _mm_shuffle_ps(y.v, z.v, _MM_SHUFFLE(1,1,1,1));   // y1 y1 z1 z1
+  const __m128 xy2 = _mm_shuffle_ps(x.v, y.v, _MM_SHUFFLE(2,2,2,2));  // x2 x2 y2 y2
+  const __m128 zx3 = _mm_shuffle_ps(z.v, x.v, _MM_SHUFFLE(3,3,2,2));  // z2 z2 x3 x3
+  const __m128 yz3 = _mm_shuffle_ps(y.v, z.v, _MM_SHUFFLE(3,3,3,3));  // y3 y3 z3 z3
+  _mm_storeu_ps(p,     _mm_shuffle_ps(xy,  zx,  _MM_SHUFFLE(2,0,2,0)));
+  _mm_storeu_ps(p + 4, _mm_shuffle_ps(yz,  xy2, _MM_SHUFFLE(2,0,2,0)));
+  _mm_storeu_ps(p + 8, _mm_shuffle_ps(zx3, yz3, _MM_SHUFFLE(2,0,2,0)));
+#else
+  for(int i = 0; i < 4; ++i) { p[3*i] = x.v[i]; p[3*i+1] = y.v[i]; p[3*i+2] = z.v[i]; }
+#endif
+}
+/** @endcond */
+
+/** Returns lane i */
+OPTIXU_INLINE float getByIndex(const floatx4& a, int i)
+{
+  return ((const float*)(&a.v))[i];
+}
+
+/** Sets lane i */
+OPTIXU_INLINE void setByIndex(floatx4& a, int i, float x)
+{
+  ((float*)(&a.v))[i] = x;
+}
+
+#if defined(OPTIXU_SOA_SSE)
+#  define OPTIXU_SOA_X4_OP(sse, op) floatx4 r; r.v = sse(a.v, b.v); return r;
+#else
+#  define OPTIXU_SOA_X4_OP(sse, op) floatx4 r; for(int i = 0; i < 4; ++i) r.v[i] = op(a.v[i], b.v[i]); return r;
+#endif
+
+/** @cond */
+OPTIXU_INLINE float soa_add(const float a, const float b) { return a + b; }
+OPTIXU_INLINE float soa_sub(const float a, const float b) { return a - b; }
+OPTIXU_INLINE float soa_mul(const float a, const float b) { return a * b; }
+OPTIXU_INLINE float soa_div(const float a, const float b) { return a / b; }
+OPTIXU_INLINE float soa_min(const float a, const float b) { return a < b ? a : b; }
+OPTIXU_INLINE float soa_max(const float a, const float b) { return a > b ? a : b; }
+/** @endcond */
+
+/** min */
+OPTIXU_INLINE floatx4 fminf(const floatx4& a, const floatx4& b)
+{
+  OPTIXU_SOA_X4_OP(_mm_min_ps, soa_min)
+}
+
+/** max */
+OPTIXU_INLINE floatx4 fmaxf(const floatx4& a, const floatx4& b)
+{
+  OPTIXU_SOA_X4_OP(_mm_max_ps, soa_max)
+}
+
+/** add */
+OPTIXU_INLINE floatx4 operator+(const floatx4& a, const floatx4& b)
+{
+  OPTIXU_SOA_X4_OP(_mm_add_ps, soa_add)
+}
+
+/** subtract */
+OPTIXU_INLINE floatx4 operator-(const floatx4& a, const floatx4& b)
+{
+  OPTIXU_SOA_X4_OP(_mm_sub_ps, soa_sub)
+}
+
+/** multiply */
+OPTIXU_INLINE floatx4 operator*(const floatx4& a, const floatx4& b)
+{
+  OPTIXU_SOA_X4_OP(_mm_mul_ps, soa_mul)
+}
+
+/** divide */
+OPTIXU_INLINE floatx4 operator/(const floatx4& a, const floatx4& b)
+{
+  OPTIXU_SOA_X4_OP(_mm_div_ps, soa_div)
+}
+
+#undef OPTIXU_SOA_X4_OP
+
+/** negate */
+OPTIXU_INLINE floatx4 operator-(const floatx4& a)
+{
+  return a * make_floatx4(-1.0f);
+}
+
+/** square root */
+OPTIXU_INLINE floatx4 sqrtf(const floatx4& a)
+{
+  floatx4 r;
+#if defined(OPTIXU_SOA_SSE)
+  r.v = _mm_sqrt_ps(a.v);
+#else
+  for(int i = 0; i < 4; ++i) r.v[i] = ::sqrtf(a.v[i]);
+#endif
+  return r;
+}
+
+/** Returns a mask with bit i set where lane i of a is less than or equal to lane i of b */
+OPTIXU_INLINE int lessEqualMask(const floatx4& a, const floatx4& b)
+{
+#if defined(OPTIXU_SOA_SSE)
+  return _mm_movemask_ps(_mm_cmple_ps(a.v, b.v));
+#else
+  int mask = 0;
+  for(int i = 0; i < 4; ++i) mask |= (a.v[i] <= b.v[i]) << i;
+  return mask;
+#endif
+}
+
+/** Returns a mask with bit i set where lane i of a is less than lane i of b */
+OPTIXU_INLINE int lessMask(const floatx4& a, const floatx4& b)
+{
+#if defined(OPTIXU_SOA_SSE)
+  return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v));
+#else
+  int mask = 0;
+  for(int i = 0; i < 4; ++i) mask |= (a.v[i] < b.v[i]) << i;
+  return mask;
+#endif
+}
+
+/** @cond */
+/** a*b - c*d per lane, as watertight_difference_of_products computes it */
+OPTIXU_INLINE floatx4 watertight_difference_of_products(const floatx4& a, const floatx4& b, const floatx4& c, const floatx4& d)
+{
+  floatx4 r;
+#if defined(OPTIXU_SOA_AVX)
+  r.v = _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_mul_pd(_mm256_cvtps_pd(a.v), _mm256_cvtps_pd(b.v)),
+                                      _mm256_mul_pd(_mm256_cvtps_pd(c.v), _mm256_cvtps_pd(d.v))));
+#elif defined(OPTIXU_SOA_SSE2)
+  const __m128d lo = _mm_sub_pd(_mm_mul_pd(_mm_cvtps_pd(a.v), _mm_cvtps_pd(b.v)),
+                                _mm_mul_pd(_mm_cvtps_pd(c.v), _mm_cvtps_pd(d.v)));
+  const __m128d hi = _mm_sub_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(a.v, a.v)), _mm_cvtps_pd(_mm_movehl_ps(b.v, b.v))),
+                                _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(c.v, c.v)), _mm_cvtps_pd(_mm_movehl_ps(d.v, d.v))));
+  r.v = _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+#else
+  float av[4], bv[4], cv[4], dv[4], rv[4];
+  store(av, a); store(bv, b); store(cv, c); store(dv, d);
+  for(int i = 0; i < 4; ++i) rv[i] = watertight_difference_of_products(av[i], bv[i], cv[i], dv[i]);
+  r = loadx4(rv);
+#endif
+  return r;
+}
+/** @endcond */
+
+/* floatx8 functions */
+/******************************************************************************/
+
+/** Eight floats, one per lane. Without AVX the lanes are kept as two floatx4. */
+struct floatx8
+{
+#if defined(OPTIXU_SOA_AVX)
+  __m256 v;
+#else
+  floatx4 lo, hi;
+#endif
+};
+
+/** constructors
+* @{
+*/
+OPTIXU_INLINE floatx8 make_floatx8(const float s)
+{
+  floatx8 r;
+#if defined(OPTIXU_SOA_AVX)
+  r.v = _mm256_set1_ps(s);
+#else
+  r.lo = r.hi = make_floatx4(s);
+#endif
+  return r;
+}
+OPTIXU_INLINE floatx8 make_floatx8(const floatx4& lo, const floatx4& hi)
+{
+  floatx8 r;
+#if defined(OPTIXU_SOA_AVX)
+  r.v = _mm256_insertf128_ps(_mm256_castps128_ps256(lo.v), hi.v, 1);
+#else
+  r.lo = lo;
+  r.hi = hi;
+#endif
+  return r;
+}
+/** @} */
+
+/** Loads lanes from 8 consecutive floats, which need not be aligned */
+OPTIXU_INLINE floatx8 loadx8(const float* p)
+{
+  floatx8 r;
+#if defined(OPTIXU_SOA_AVX)
+  r.v = _mm256_loadu_ps(p);
+#else
+  r.lo = loadx4(p);
+  r.hi = loadx4(p + 4);
+#endif
+  return r;
+}
+
+/** Stores lanes to 8 consecutive floats, which need not be aligned */
+OPTIXU_INLINE void store(float* p, const floatx8& a)
+{
+#if defined(OPTIXU_SOA_AVX)
+  _mm256_storeu_ps(p, a.v);
+#else
+  store(p, a.lo);
+  store(p + 4, a.hi);
+#endif
+}
+
+/** @cond */
+// Transposes 8 consecutive float3s at p into x, y and z lanes, and back
+OPTIXU_INLINE void soa_load3(const float* p, floatx8& x, floatx8& y, floatx8& z)
+{
+  floatx4 xl, yl, zl, xh, yh, zh;
+  soa_load3(p, xl, yl, zl);
+  soa_load3(p + 12, xh, yh, zh);
+  x = make_floatx8(xl, xh); y = make_floatx8(yl, yh); z = make_floatx8(zl, zh);
+}
+OPTIXU_INLINE void soa_store3(float* p, const floatx8& x, const floatx8& y, const floatx8& z)
+{
+#if defined(OPTIXU_SOA_AVX)
+  floatx4 xl, yl, zl, xh, yh, zh;
+  xl.v = _mm256_castps256_ps128(x.v); xh.v = _mm256_extractf128_ps(x.v, 1);
+  yl.v = _mm256_castps256_ps128(y.v); yh.v = _mm256_extractf128_ps(y.v, 1);
+  zl.v = _mm256_castps256_ps128(z.v); zh.v = _mm256_extractf128_ps(z.v, 1);
+  soa_store3(p, xl, yl, zl);
+  soa_store3(p + 12, xh, yh, zh);
+#else
+  soa_store3(p, x.lo, y.lo, z.lo);
+  soa_store3(p + 12, x.hi, y.hi, z.hi);
+#endif
+}
+/** @endcond */
+
+/** Returns lane i */
+OPTIXU_INLINE float getByIndex(const floatx8& a, int i)
+{
+  return ((const float*)(&a))[i];
+}
+
+/** Sets lane i */
+OPTIXU_INLINE void setByIndex(floatx8& a, int i, float x)
+{
+  ((float*)(&a))[i] = x;
+}
+
+#if defined(OPTIXU_SOA_AVX)
+#  define OPTIXU_SOA_X8_OP(avx, op) floatx8 r; r.v = avx(a.v, b.v); return r;
+#else
+#  define OPTIXU_SOA_X8_OP(avx, op) floatx8 r; r.lo = op(a.lo, b.lo); r.hi = op(a.hi, b.hi); return r;
+#endif
+
+/** min */
+OPTIXU_INLINE floatx8 fminf(const floatx8& a, const floatx8& b)
+{
+  OPTIXU_SOA_X8_OP(_mm256_min_ps, fminf)
+}
+
+/** max */
+OPTIXU_INLINE floatx8 fmaxf(const floatx8& a, const floatx8& b)
+{
+  OPTIXU_SOA_X8_OP(_mm256_max_ps, fmaxf)
+}
+
+/** add */
+OPTIXU_INLINE floatx8 operator+(const floatx8& a, const floatx8& b)
+{
+  OPTIXU_SOA_X8_OP(_mm256_add_ps, operator+)
+}
+
+/** subtract */
+OPTIXU_INLINE floatx8 operator-(const floatx8& a, const floatx8& b)
+{
+  OPTIXU_SOA_X8_OP(_mm256_sub_ps, operator-)
+}
+
+/** multiply */
+OPTIXU_INLINE floatx8 operator*(const floatx8& a, const floatx8& b)
+{
+  OPTIXU_SOA_X8_OP(_mm256_mul_ps, operator*)
+}
+
+/** divide */
+OPTIXU_INLINE floatx8 operator/(const floatx8& a, const floatx8& b)
+{
+  OPTIXU_SOA_X8_OP(_mm256_div_ps, operator/)
+}
+
+#undef OPTIXU_SOA_X8_OP
+
+/** negate */
+OPTIXU_INLINE floatx8 operator-(const floatx8& a)
+{
+  return a * make_floatx8(-1.0f);
+}
+
+/** square root */
+OPTIXU_INLINE floatx8 sqrtf(const floatx8& a)
+{
+  floatx8 r;
+#if defined(OPTIXU_SOA_AVX)
+  r.v = _mm256_sqrt_ps(a.v);
+#else
+  r.lo = sqrtf(a.lo);
+  r.hi = sqrtf(a.hi);
+#endif
+  return r;
+}
+
+/** Returns a mask with bit i set where lane i of a is less than or equal to lane i of b */
+OPTIXU_INLINE int lessEqualMask(const floatx8& a, const floatx8& b)
+{
+#if defined(OPTIXU_SOA_AVX)
+  return _mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ));
+#else
+  return lessEqualMask(a.lo, b.lo) | (lessEqualMask(a.hi, b.hi) << 4);
+#endif
+}
+
+/** Returns a mask with bit i set where lane i of a is less than lane i of b */
+OPTIXU_INLINE int lessMask(const floatx8& a, const floatx8& b)
+{
+#if defined(OPTIXU_SOA_AVX)
+  return _mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ));
+#else
+  return lessMask(a.lo, b.lo) | (lessMask(a.hi, b.hi) << 4);
+#endif
+}
+
+/** @cond */
+/** a*b - c*d per lane, as watertight_difference_of_products computes it */
+OPTIXU_INLINE floatx8 watertight_difference_of_products(const floatx8& a, const floatx8& b, const floatx8& c, const floatx8& d)
+{
+#if defined(OPTIXU_SOA_AVX)
+  floatx4 al, ah, bl, bh, cl, ch, dl, dh;
+  al.v = _mm256_castps256_ps128(a.v); ah.v = _mm256_extractf128_ps(a.v, 1);
+  bl.v = _mm256_castps256_ps128(b.v); bh.v = _mm256_extractf128_ps(b.v, 1);
+  cl.v = _mm256_castps256_ps128(c.v); ch.v = _mm256_extractf128_ps(c.v, 1);
+  dl.v = _mm256_castps256_ps128(d.v); dh.v = _mm256_extractf128_ps(d.v, 1);
+  return make_floatx8(watertight_difference_of_products(al, bl, cl, dl), watertight_difference_of_products(ah, bh, ch, dh));
+#else
+  return make_floatx8(watertight_difference_of_products(a.lo, b.lo, c.lo, d.lo), watertight_difference_of_products(a.hi, b.hi, c.hi, d.hi));
+#endif
+}
+/** @endcond */
+
+/* functions shared by floatx4 and floatx8 */
+/******************************************************************************/
+
+#define OPTIXU_SOA_FLOATXN_FUNCTIONS(floatxN, make_floatxN)                           \
+                                                                                      \
+/** scalar operands are broadcast to all lanes */                                     \
+OPTIXU_INLINE floatxN operator+(const floatxN& a, const float b)                      \
+{ return a + make_floatxN(b); }                                                       \
+OPTIXU_INLINE floatxN operator+(const float a, const floatxN& b)                      \
+{ return make_floatxN(a) + b; }                                                       \
+OPTIXU_INLINE floatxN operator-(const floatxN& a, const float b)                      \
+{ return a - make_floatxN(b); }                                                       \
+OPTIXU_INLINE floatxN operator-(const float a, const floatxN& b)                      \
+{ return make_floatxN(a) - b; }                                                       \
+OPTIXU_INLINE floatxN operator*(const floatxN& a, const float b)                      \
+{ return a * make_floatxN(b); }                                                       \
+OPTIXU_INLINE floatxN operator*(const float a, const floatxN& b)                      \
+{ return make_floatxN(a) * b; }                                                       \
+OPTIXU_INLINE floatxN operator/(const floatxN& a, const float b)                      \
+{ return a / make_floatxN(b); }                                                       \
+OPTIXU_INLINE floatxN operator/(const float a, const floatxN& b)                      \
+{ return make_floatxN(a) / b; }                                                       \
+OPTIXU_INLINE void operator+=(floatxN& a, const floatxN& b)                           \
+{ a = a + b; }                                                                        \
+OPTIXU_INLINE void operator-=(floatxN& a, const floatxN& b)                           \
+{ a = a - b; }                                                                        \
+OPTIXU_INLINE void operator*=(floatxN& a, const floatxN& b)                           \
+{ a = a * b; }                                                                        \
+OPTIXU_INLINE void operator/=(floatxN& a, const floatxN& b)                           \
+{ a = a / b; }                                                                        \
+                                                                                      \
+/** lerp */                                                                           \
+OPTIXU_INLINE floatxN lerp(const floatxN& a, const floatxN& b, const floatxN& t)      \
+{ return a + t*(b-a); }                                                               \
+                                                                                      \
+/** clamp */                                                                          \
+OPTIXU_INLINE floatxN clamp(const floatxN& f, const floatxN& a, const floatxN& b)     \
+{ return fmaxf(a, fminf(f, b)); }                                                     \
+OPTIXU_INLINE floatxN clamp(const floatxN& f, const float a, const float b)           \
+{ return clamp(f, make_floatxN(a), make_floatxN(b)); }
+
+OPTIXU_SOA_FLOATXN_FUNCTIONS(floatx4, make_floatx4)
+OPTIXU_SOA_FLOATXN_FUNCTIONS(floatx8, make_floatx8)
+
+#undef OPTIXU_SOA_FLOATXN_FUNCTIONS
+
+/* float3x4 and float3x8 functions */
+/******************************************************************************/
+
+/** Four float3s, one per lane, stored as one packet per component */
+struct float3x4
+{
+  floatx4 x, y, z;
+};
+
+/** Eight float3s, one per lane, stored as one packet per component */
+struct float3x8
+{
+  floatx8 x, y, z;
+};
+
+#define OPTIXU_SOA_FLOAT3XN_FUNCTIONS(float3xN, floatxN, make_float3xN, make_floatxN) \
+                                                                                      \
+/** constructors */                                                                   \
+OPTIXU_INLINE float3xN make_float3xN(const floatxN& x, const floatxN& y, const floatxN& z) \
+{ float3xN r; r.x = x; r.y = y; r.z = z; return r; }                                  \
+OPTIXU_INLINE float3xN make_float3xN(const float3& a)                                 \
+{ return make_float3xN(make_floatxN(a.x), make_floatxN(a.y), make_floatxN(a.z)); }    \
+                                                                                      \
+/** Gathers one float3 per lane from consecutive float3s */                          \
+OPTIXU_INLINE float3xN make_float3xN(const float3* a)                                 \
+{ float3xN r; soa_load3(&a->x, r.x, r.y, r.z); return r; }                            \
+                                                                                      \
+/** Scatters the lanes to consecutive float3s */                                      \
+OPTIXU_INLINE void store(float3* a, const float3xN& v)                                \
+{ soa_store3(&a->x, v.x, v.y, v.z); }                                                 \
+                                                                                      \
+/** Returns or sets lane i */                                                         \
+OPTIXU_INLINE float3 getByIndex(const float3xN& v, int i)                             \
+{ return make_float3(getByIndex(v.x, i), getByIndex(v.y, i), getByIndex(v.z, i)); }   \
+OPTIXU_INLINE void setByIndex(float3xN& v, int i, const float3& a)                    \
+{ setByIndex(v.x, i, a.x); setByIndex(v.y, i, a.y); setByIndex(v.z, i, a.z); }        \
+                                                                                      \
+/** negate */                                                                         \
+OPTIXU_INLINE float3xN operator-(const float3xN& a)                                   \
+{ return make_float3xN(-a.x, -a.y, -a.z); }                                           \
+                                                                                      \
+/** min */                                                                            \
+OPTIXU_INLINE float3xN fminf(const float3xN& a, const float3xN& b)                    \
+{ return make_float3xN(fminf(a.x,b.x), fminf(a.y,b.y), fminf(a.z,b.z)); }             \
+                                                                                      \
+/** max */                                                                            \
+OPTIXU_INLINE float3xN fmaxf(const float3xN& a, const float3xN& b)                    \
+{ return make_float3xN(fmaxf(a.x,b.x), fmaxf(a.y,b.y), fmaxf(a.z,b.z)); }             \
+                                                                                      \
+/** add */                                                                            \
+OPTIXU_INLINE float3xN operator+(const float3xN& a, const float3xN& b)                \
+{ return make_float3xN(a.x+b.x, a.y+b.y, a.z+b.z); }                                  \
+OPTIXU_INLINE void operator+=(float3xN& a, const float3xN& b)                         \
+{ a = a + b; }                                                                        \
+                                                                                      \
+/** subtract */                                                                       \
+OPTIXU_INLINE float3xN operator-(const float3xN& a, const float3xN& b)                \
+{ return make_float3xN(a.x-b.x, a.y-b.y, a.z-b.z); }                                  \
+OPTIXU_INLINE void operator-=(float3xN& a, const float3xN& b)                         \
+{ a = a - b; }                                                                        \
+                                                                                      \
+/** multiply */                                                                       \
+OPTIXU_INLINE float3xN operator*(const float3xN& a, const float3xN& b)                \
+{ return make_float3xN(a.x*b.x, a.y*b.y, a.z*b.z); }                                  \
+OPTIXU_INLINE float3xN operator*(const float3xN& a, const floatxN& s)                 \
+{ return make_float3xN(a.x*s, a.y*s, a.z*s); }                                        \
+OPTIXU_INLINE float3xN operator*(const floatxN& s, const float3xN& a)                 \
+{ return a * s; }                                                                     \
+OPTIXU_INLINE float3xN operator*(const float3xN& a, const float s)                    \
+{ return a * make_floatxN(s); }                                                       \
+OPTIXU_INLINE float3xN operator*(const float s, const float3xN& a)                    \
+{ return a * make_floatxN(s); }                                                       \
+OPTIXU_INLINE void operator*=(float3xN& a, const float3xN& b)                         \
+{ a = a * b; }                                                                        \
+OPTIXU_INLINE void operator*=(float3xN& a, const floatxN& s)                          \
+{ a = a * s; }                                                                        \
+                                                                                      \
+/** divide */                                                                         \
+OPTIXU_INLINE float3xN operator/(const float3xN& a, const float3xN& b)                \
+{ return make_float3xN(a.x/b.x, a.y/b.y, a.z/b.z); }                                  \
+OPTIXU_INLINE float3xN operator/(const float3xN& a, const floatxN& s)                 \
+{ return a * (1.0f / s); }                                                            \
+OPTIXU_INLINE float3xN operator/(const float3xN& a, const float s)                    \
+{ return a * (1.0f / s); }                                                            \
+OPTIXU_INLINE void operator/=(float3xN& a, const floatxN& s)                          \
+{ a = a / s; }                                                                        \
+                                                                                      \
+/** lerp */                                                                           \
+OPTIXU_INLINE float3xN lerp(const float3xN& a, const float3xN& b, const floatxN& t)   \
+{ return a + t*(b-a); }                                                               \
+                                                                                      \
+/** clamp */                                                                          \
+OPTIXU_INLINE float3xN clamp(const float3xN& v, const float a, const float b)         \
+{ return make_float3xN(clamp(v.x, a, b), clamp(v.y, a, b), clamp(v.z, a, b)); }       \
+OPTIXU_INLINE float3xN clamp(const float3xN& v, const float3xN& a, const float3xN& b) \
+{ return fmaxf(a, fminf(v, b)); }                                                     \
+                                                                                      \
+/** dot product */                                                                    \
+OPTIXU_INLINE floatxN dot(const float3xN& a, const float3xN& b)                       \
+{ return a.x*b.x + a.y*b.y + a.z*b.z; }                                               \
+                                                                                      \
+/** cross product */                                                                  \
+OPTIXU_INLINE float3xN cross(const float3xN& a, const float3xN& b)                    \
+{ return make_float3xN(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x); }    \
+                                                                                      \
+/** length */                                                                         \
+OPTIXU_INLINE floatxN length(const float3xN& v)                                       \
+{ return sqrtf(dot(v, v)); }                                                          \
+                                                                                      \
+/** normalize */                                                                      \
+OPTIXU_INLINE float3xN normalize(const float3xN& v)                                   \
+{ floatxN invLen = 1.0f / sqrtf(dot(v, v)); return v * invLen; }                      \
+                                                                                      \
+/** reflect */                                                                        \
+OPTIXU_INLINE float3xN reflect(const float3xN& i, const float3xN& n)                  \
+{ return i - 2.0f * n * dot(n,i); }
+
+OPTIXU_SOA_FLOAT3XN_FUNCTIONS(float3x4, floatx4, make_float3x4, make_floatx4)
+OPTIXU_SOA_FLOAT3XN_FUNCTIONS(float3x8, floatx8, make_float3x8, make_floatx8)
+
+#undef OPTIXU_SOA_FLOAT3XN_FUNCTIONS
+
+/* triangle blocks */
+/******************************************************************************/
+
+/** 4 or 8 triangles prepared for intersect_triangles_branchless: the first vertex p0, the edges e0 = p1 - p0 and
+* e1 = p0 - p2, and the unnormalized normal n = cross(e1, e0), as intersect_triangle_branchless computes them.
+* @{
+*/
+struct Trianglesx4
+{
+  float3x4 p0, e0, e1, n;
+};
+struct Trianglesx8
+{
+  float3x8 p0, e0, e1, n;
+};
+/** @} */
+
+/* make_Trianglesx4/8(vertices, indices, first, count) gathers triangles first .. first+count-1, indexed as in
+ * optix::prime::ModelObj::setTriangles, or three consecutive vertices per triangle if indices is 0. Lanes from count
+ * on hold degenerate triangles, which are never hit.
+ *
+ * intersect_triangles_branchless(ray, triangles, t, beta, gamma) tests the ray against every triangle of the block,
+ * each lane with the same operations as intersect_triangle_branchless. It returns the lane of the nearest hit, or -1,
+ * and sets t, beta and gamma for that lane; the hit normal is getByIndex(triangles.n, lane). Equal t go to the lowest
+ * lane. t, beta and gamma only match the scalar version bit for bit without FP contraction (FMA), e.g. with
+ * -ffp-contract=off, so with it a ray through an edge may pick a different lane.
+ */
+
+#define OPTIXU_SOA_TRIANGLES_FUNCTIONS(TrianglesxN, make_TrianglesxN, float3xN, floatxN, make_float3xN, make_floatxN, N) \
+                                                                                      \
+/** gather triangles first .. first+count-1 */                                        \
+OPTIXU_INLINE TrianglesxN make_TrianglesxN(const float3* vertices, const int3* indices, \
+                                           RTsize first, unsigned int count = N)      \
+{                                                                                     \
+  float3 p0[N], e0[N], e1[N], n[N];                                                   \
+  for(unsigned int i = 0; i < N; ++i) {                                               \
+    p0[i] = e0[i] = e1[i] = n[i] = make_float3(0.0f);                                 \
+    if(i >= count) continue;                                                          \
+    const RTsize t = first + i;                                                       \
+    const int3 idx = indices ? indices[t] : make_int3(int(3*t), int(3*t+1), int(3*t+2)); \
+    p0[i] = vertices[idx.x];                                                          \
+    e0[i] = vertices[idx.y] - p0[i];                                                  \
+    e1[i] = p0[i] - vertices[idx.z];                                                  \
+    n[i]  = cross(e1[i], e0[i]);                                                      \
+  }                                                                                   \
+  TrianglesxN r;                                                                      \
+  r.p0 = make_float3xN(p0);                                                           \
+  r.e0 = make_float3xN(e0);                                                           \
+  r.e1 = make_float3xN(e1);                                                           \
+  r.n  = make_float3xN(n);                                                            \
+  return r;                                                                           \
+}                                                                                     \
+                                                                                      \
+/** nearest hit in the block */                                                       \
+OPTIXU_INLINE int intersect_triangles_branchless(const Ray& ray, const TrianglesxN& tri, \
+                                                 float& t, float& beta, float& gamma) \
+{                                                                                     \
+  const float3xN d  = make_float3xN(ray.direction);                                   \
+  const float3xN e2 = (1.0f / dot(tri.n, d)) * (tri.p0 - make_float3xN(ray.origin));  \
+  const float3xN i  = cross(d, e2);                                                   \
+                                                                                      \
+  const floatxN b  = dot(i, tri.e1);                                                  \
+  const floatxN g  = dot(i, tri.e0);                                                  \
+  const floatxN tt = dot(tri.n, e2);                                                  \
+                                                                                      \
+  const floatxN zero = make_floatxN(0.0f);                                            \
+  const int mask = lessMask(tt, make_floatxN(ray.tmax)) &                             \
+                   lessMask(make_floatxN(ray.tmin), tt) &                             \
+                   lessEqualMask(zero, b) & lessEqualMask(zero, g) &                  \
+                   lessEqualMask(b + g, make_floatxN(1.0f));                          \
+  if(!mask)                                                                           \
+    return -1;                                                                        \
+                                                                                      \
+  float ts[N];                                                                        \
+  store(ts, tt);                                                                      \
+  int lane = -1;                                                                      \
+  for(int k = 0; k < N; ++k)                                                          \
+    if(((mask >> k) & 1) && (lane < 0 || ts[k] < ts[lane]))                           \
+      lane = k;                                                                       \
+  t     = ts[lane];                                                                   \
+  beta  = getByIndex(b, lane);                                                        \
+  gamma = getByIndex(g, lane);                                                        \
+  return lane;                                                                        \
+}
+
+OPTIXU_SOA_TRIANGLES_FUNCTIONS(Trianglesx4, make_Trianglesx4, float3x4, floatx4, make_float3x4, make_floatx4, 4)
+OPTIXU_SOA_TRIANGLES_FUNCTIONS(Trianglesx8, make_Trianglesx8, float3x8, floatx8, make_float3x8, make_floatx8, 8)
+
+#undef OPTIXU_SOA_TRIANGLES_FUNCTIONS
+
+/** 4 or 8 triangles prepared for intersect_triangles_watertight: the vertices p0, p1 and p2. The edges of
+* Trianglesx4/8 would not reproduce the vertices exactly, and triangles sharing an edge must see the same vertices
+* for the test to be watertight.
+* @{
+*/
+struct WatertightTrianglesx4
+{
+  float3x4 p0, p1, p2;
+};
+struct WatertightTrianglesx8
+{
+  float3x8 p0, p1, p2;
+};
+/** @} */
+
+/* make_WatertightTrianglesx4/8(vertices, indices, first, count) gathers triangles as make_Trianglesx4/8 does. Lanes
+ * from count on hold NaN vertices, which are never hit.
+ *
+ * intersect_triangles_watertight(ray, wr, triangles, n, t, beta, gamma) tests the ray against every triangle of the
+ * block, each lane as intersect_triangle_watertight does, so a ray through a shared edge or vertex hits at least one
+ * of the triangles. It returns the lane of the nearest hit, or -1, and sets n, t, beta and gamma for that lane. Equal t
+ * go to the lowest lane. Compute wr = make_watertight_ray(ray) once per ray; the overload without wr computes it on
+ * every call.
+ */
+
+#define OPTIXU_SOA_WATERTIGHT_FUNCTIONS(WatertightTrianglesxN, make_WatertightTrianglesxN, float3xN, floatxN, make_float3xN, make_floatxN, N) \
+                                                                                      \
+/** gather triangles first .. first+count-1 */                                        \
+OPTIXU_INLINE WatertightTrianglesxN make_WatertightTrianglesxN(const float3* vertices, const int3* indices, \
+                                                               RTsize first, unsigned int count = N) \
+{                                                                                     \
+  float3 p0[N], p1[N], p2[N];                                                         \
+  for(unsigned int i = 0; i < N; ++i) {                                               \
+    p0[i] = p1[i] = p2[i] = make_float3(int_as_float(0x7fc00000));                    \
+    if(i >= count) continue;                                                          \
+    const RTsize t = first + i;                                                       \
+    const int3 idx = indices ? indices[t] : make_int3(int(3*t), int(3*t+1), int(3*t+2)); \
+    p0[i] = vertices[idx.x];                                                          \
+    p1[i] = vertices[idx.y];                                                          \
+    p2[i] = vertices[idx.z];                                                          \
+  }                                                                                   \
+  WatertightTrianglesxN r;                                                            \
+  r.p0 = make_float3xN(p0);                                                           \
+  r.p1 = make_float3xN(p1);                                                           \
+  r.p2 = make_float3xN(p2);                                                           \
+  return r;                                                                           \
+}                                                                                     \
+                                                                                      \
+/** nearest hit in the block */                                                       \
+OPTIXU_INLINE int intersect_triangles_watertight(const Ray& ray, const WatertightRay& wr, \
+                                                 const WatertightTrianglesxN& tri,    \
+                                                 float3& n, float& t, float& beta, float& gamma) \
+{                                                                                     \
+  /* The components of the packets and of the ray, indexed as the scalar version indexes float3s */ \
+  const floatxN* P0 = &tri.p0.x;                                                      \
+  const floatxN* P1 = &tri.p1.x;                                                      \
+  const floatxN* P2 = &tri.p2.x;                                                      \
+  const float* O = reinterpret_cast<const float*>( &ray.origin );                     \
+  const floatxN ox = make_floatxN(O[wr.kx]);                                          \
+  const floatxN oy = make_floatxN(O[wr.ky]);                                          \
+  const floatxN oz = make_floatxN(O[wr.kz]);                                          \
+  const floatxN sx = make_floatxN(wr.sx);                                             \
+  const floatxN sy = make_floatxN(wr.sy);                                             \
+                                                                                      \
+  /* Shear the vertices into the ray's space */                                       \
+  const floatxN one = make_floatxN(1.0f);                                             \
+  const floatxN az = P0[wr.kz] - oz;                                                  \
+  const floatxN bz = P1[wr.kz] - oz;                                                  \
+  const floatxN cz = P2[wr.kz] - oz;                                                  \
+  const floatxN ax = watertight_difference_of_products(P0[wr.kx] - ox, one, sx, az);  \
+  const floatxN ay = watertight_difference_of_products(P0[wr.ky] - oy, one, sy, az);  \
+  const floatxN bx = watertight_difference_of_products(P1[wr.kx] - ox, one, sx, bz);  \
+  const floatxN by = watertight_difference_of_products(P1[wr.ky] - oy, one, sy, bz);  \
+  const floatxN cx = watertight_difference_of_products(P2[wr.kx] - ox, one, sx, cz);  \
+  const floatxN cy = watertight_difference_of_products(P2[wr.ky] - oy, one, sy, cz);  \
+                                                                                      \
+  const floatxN u = watertight_difference_of_products(cx, by, cy, bx);                \
+  const floatxN v = watertight_difference_of_products(ax, cy, ay, cx);                \
+  const floatxN w = watertight_difference_of_products(bx, ay, by, ax);                \
+                                                                                      \
+  const floatxN zero = make_floatxN(0.0f);                                            \
+  const floatxN det = u + v + w;                                                      \
+  const floatxN rcp = 1.0f / det;                                                     \
+  const floatxN tt  = ( make_floatxN(wr.sz) * ( u*az + v*bz + w*cz ) ) * rcp;         \
+                                                                                      \
+  /* A NaN in u, v or w, which fminf and fmaxf may skip, makes tt NaN, failing the t */ \
+  /* tests. u, v and w of one sign only sum to 0 if all are 0, and then tt is NaN too. */ \
+  const int inside = lessEqualMask(zero, fminf(fminf(u, v), w)) |                     \
+                     lessEqualMask(fmaxf(fmaxf(u, v), w), zero);                      \
+  const int mask = inside &                                                           \
+                   lessMask(tt, make_floatxN(ray.tmax)) &                             \
+                   lessMask(make_floatxN(ray.tmin), tt);                              \
+  if(!mask)                                                                           \
+    return -1;                                                                        \
+                                                                                      \
+  float ts[N];                                                                        \
+  store(ts, tt);                                                                      \
+  int lane = -1;                                                                      \
+  for(int k = 0; k < N; ++k)                                                          \
+    if(((mask >> k) & 1) && (lane < 0 || ts[k] < ts[lane]))                           \
+      lane = k;                                                                       \
+  const float3 p0 = getByIndex(tri.p0, lane);                                         \
+  n     = cross(p0 - getByIndex(tri.p2, lane), getByIndex(tri.p1, lane) - p0);        \
+  t     = ts[lane];                                                                   \
+  beta  = getByIndex(v, lane) * getByIndex(rcp, lane);                                \
+  gamma = getByIndex(w, lane) * getByIndex(rcp, lane);                                \
+  return lane;                                                                        \
+}                                                                                     \
+OPTIXU_INLINE int intersect_triangles_watertight(const Ray& ray, const WatertightTrianglesxN& tri, \
+                                                 float3& n, float& t, float& beta, float& gamma) \
+{                                                                                     \
+  return intersect_triangles_watertight(ray, make_watertight_ray(ray), tri, n, t, beta, gamma); \
+}
+
+OPTIXU_SOA_WATERTIGHT_FUNCTIONS(WatertightTrianglesx4, make_WatertightTrianglesx4, float3x4, floatx4, make_float3x4, make_floatx4, 4)
+OPTIXU_SOA_WATERTIGHT_FUNCTIONS(WatertightTrianglesx8, make_WatertightTrianglesx8, float3x8, floatx8, make_float3x8, make_floatx8, 8)
+
+#undef OPTIXU_SOA_WATERTIGHT_FUNCTIONS
+
+} // end namespace optix
+
+#ifdef OPTIXU_INLINE_DEFINED
+#  undef OPTIXU_INLINE_DEFINED
+#  undef OPTIXU_INLINE
+#endif
+
+#endif // #if !defined(__CUDACC__)
+
+#endif // #ifndef __optixu_optixu_math_soa_namespace_h__
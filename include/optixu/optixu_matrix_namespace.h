@@ -43,6 +43,13 @@
 #define RT_MATRIX_ACCESS(m,i,j) m[i*N+j]
 #define RT_MAT_DECL template <unsigned int M, unsigned int N>
 
+// constexpr constructors must initialize every member before C++20
+#if defined(OPTIXU_CONSTEXPR_ENABLED) && __cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L)
+#  define RT_MATRIX_INIT_DATA : m_data()
+#else
+#  define RT_MATRIX_INIT_DATA
+#endif
+
 namespace optix {
 
   template <int DIM> struct VectorDim { };
@@ -53,7 +60,7 @@ namespace optix {
 
   template <unsigned int M, unsigned int N> class Matrix;
 
-   template <unsigned int M> OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,M>& operator*=(Matrix<M,M>& m1, const Matrix<M,M>& m2);
+   template <unsigned int M> OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<M,M>& operator*=(Matrix<M,M>& m1, const Matrix<M,M>& m2);
    RT_MAT_DECL OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,N>& operator-=(Matrix<M,N>& m1, const Matrix<M,N>& m2);
    RT_MAT_DECL OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,N>& operator+=(Matrix<M,N>& m1, const Matrix<M,N>& m2);
    RT_MAT_DECL OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,N>& operator*=(Matrix<M,N>& m1, float f);
@@ -65,7 +72,7 @@ namespace optix {
    RT_MAT_DECL OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,N> operator*(float f, const Matrix<M,N>& m);
    RT_MAT_DECL OPTIXU_INLINE RT_HOSTDEVICE typename Matrix<M,N>::floatM operator*(const Matrix<M,N>& m, const typename Matrix<M,N>::floatN& v );
    RT_MAT_DECL OPTIXU_INLINE RT_HOSTDEVICE typename Matrix<M,N>::floatN operator*(const typename Matrix<M,N>::floatM& v, const Matrix<M,N>& m);
-   template<unsigned int M, unsigned int N, unsigned int R> OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,R> operator*(const Matrix<M,N>& m1, const Matrix<N,R>& m2);
+   template<unsigned int M, unsigned int N, unsigned int R> OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<M,R> operator*(const Matrix<M,N>& m1, const Matrix<N,R>& m2);
 
 
   // Partial specializations to make matrix vector multiplication more efficient
@@ -75,7 +82,7 @@ namespace optix {
   OPTIXU_INLINE RT_HOSTDEVICE float3 operator*(const Matrix<3,N>& m, const typename Matrix<3,N>::floatN& vec );
   template <unsigned int N>
   OPTIXU_INLINE RT_HOSTDEVICE float4 operator*(const Matrix<4,N>& m, const typename Matrix<4,N>::floatN& vec );
-  OPTIXU_INLINE RT_HOSTDEVICE float4 operator*(const Matrix<4,4>& m, const float4& vec );
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator*(const Matrix<4,4>& m, const float4& vec );
 
   /**
   * @brief A matrix with M rows and N columns
@@ -104,23 +111,24 @@ namespace optix {
     typedef typename VectorDim<N>::VectorType  floatN; /// A row of the matrix
     typedef typename VectorDim<M>::VectorType  floatM; /// A column of the matrix
 
-	/** Create an unitialized matrix */
-	RT_HOSTDEVICE              Matrix();
+	/** Create an unitialized matrix. In host code compiled as C++14 or C++17, where this constexpr constructor must
+	*   initialize every member, the matrix is zero filled instead */
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix();
 
 	/** Create a matrix from the specified float array */
-	RT_HOSTDEVICE explicit     Matrix( const float data[M*N] ) { for(unsigned int i = 0; i < M*N; ++i) m_data[i] = data[i]; }
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR explicit Matrix( const float data[M*N] ) RT_MATRIX_INIT_DATA { for(unsigned int i = 0; i < M*N; ++i) m_data[i] = data[i]; }
 
 	/** Copy the matrix */
-	RT_HOSTDEVICE              Matrix( const Matrix& m );
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix( const Matrix& m );
 
 	/** Assignment operator */
-	RT_HOSTDEVICE Matrix&      operator=( const Matrix& b );
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix& operator=( const Matrix& b );
 
 	/** Access the specified element 0..N*M-1  */
-	RT_HOSTDEVICE float        operator[]( unsigned int i )const { return m_data[i]; }
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR float  operator[]( unsigned int i )const { return m_data[i]; }
 
 	/** Access the specified element 0..N*M-1  */
-	RT_HOSTDEVICE float&       operator[]( unsigned int i )      { return m_data[i]; }
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR float& operator[]( unsigned int i )      { return m_data[i]; }
 
 	/** Access the specified row 0..M.  Returns float, float2, float3 or float4 depending on the matrix size  */
 	RT_HOSTDEVICE floatN       getRow( unsigned int m )const;
@@ -129,10 +137,10 @@ namespace optix {
 	RT_HOSTDEVICE floatM       getCol( unsigned int n )const;
 
 	/** Returns a pointer to the internal data array.  The data array is stored in row-major order. */
-	RT_HOSTDEVICE float*       getData();
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR float* getData();
 
 	/** Returns a const pointer to the internal data array.  The data array is stored in row-major order. */
-	RT_HOSTDEVICE const float* getData()const;
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR const float* getData()const;
 
 	/** Assign the specified row 0..M.  Takes a float, float2, float3 or float4 depending on the matrix size */
 	RT_HOSTDEVICE void         setRow( unsigned int m, const floatN &r );
@@ -141,7 +149,7 @@ namespace optix {
 	RT_HOSTDEVICE void         setCol( unsigned int n, const floatM &c );
 
 	/** Returns the transpose of the matrix */
-	RT_HOSTDEVICE Matrix<N,M>         transpose() const;
+	RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<N,M> transpose() const;
 
 	/** Returns the inverse of the matrix */
 	RT_HOSTDEVICE Matrix<4,4>         inverse() const;
@@ -159,7 +167,7 @@ namespace optix {
 	RT_HOSTDEVICE static Matrix<4,4>  scale(const float3& vec);
 
 	/** Returns the identity matrix */
-	RT_HOSTDEVICE static Matrix<N,N>  identity();
+	RT_HOSTDEVICE static OPTIXU_CONSTEXPR Matrix<N,N> identity();
 
 	/** Ordered comparison operator so that the matrix can be used in an STL container */
 	RT_HOSTDEVICE bool         operator<( const Matrix<M, N>& rhs ) const;
@@ -171,19 +179,19 @@ namespace optix {
 
 
   template<unsigned int M, unsigned int N>
-  OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,N>::Matrix()
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<M,N>::Matrix() RT_MATRIX_INIT_DATA
   {
   }
 
   template<unsigned int M, unsigned int N>
-  OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,N>::Matrix( const Matrix<M,N>& m )
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<M,N>::Matrix( const Matrix<M,N>& m ) RT_MATRIX_INIT_DATA
   {
     for(unsigned int i = 0; i < M*N; ++i)
       m_data[i] = m[i];
   }
 
   template<unsigned int M, unsigned int N>
-  OPTIXU_INLINE RT_HOSTDEVICE Matrix<M,N>&  Matrix<M,N>::operator=( const Matrix& b )
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<M,N>&  Matrix<M,N>::operator=( const Matrix& b )
   {
     for(unsigned int i = 0; i < M*N; ++i)
       m_data[i] = b[i];
@@ -233,14 +241,14 @@ namespace optix {
 
 
   template<unsigned int M, unsigned int N>
-  OPTIXU_INLINE RT_HOSTDEVICE float* Matrix<M,N>::getData()
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float* Matrix<M,N>::getData()
   {
     return m_data;
   }
 
 
   template<unsigned int M, unsigned int N>
-  OPTIXU_INLINE RT_HOSTDEVICE const float* Matrix<M,N>::getData() const
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR const float* Matrix<M,N>::getData() const
   {
     return m_data;
   }
@@ -307,7 +315,7 @@ namespace optix {
 
   // Multiply two compatible matrices.
   template<unsigned int M, unsigned int N, unsigned int R>
-  RT_HOSTDEVICE Matrix<M,R> operator*( const Matrix<M,N>& m1, const Matrix<N,R>& m2)
+  RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<M,R> operator*( const Matrix<M,N>& m1, const Matrix<N,R>& m2)
   {
     Matrix<M,R> temp;
 
@@ -328,7 +336,7 @@ namespace optix {
 
   // Multiply two compatible matrices.
   template<unsigned int M>
-  RT_HOSTDEVICE Matrix<M,M>& operator*=(Matrix<M,M>& m1, const Matrix<M,M>& m2)
+  RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<M,M>& operator*=(Matrix<M,M>& m1, const Matrix<M,M>& m2)
   {
     m1 = m1*m2;
     return m1;
@@ -416,25 +424,24 @@ namespace optix {
   }
 
   // Multiply matrix4x4 by float4
-  OPTIXU_INLINE RT_HOSTDEVICE float4 operator*(const Matrix<4,4>& m, const float4& vec )
-  {
-    float4 temp;
-    temp.x  = m[ 0] * vec.x +
-              m[ 1] * vec.y +
-              m[ 2] * vec.z +
-              m[ 3] * vec.w;
-    temp.y  = m[ 4] * vec.x +
-              m[ 5] * vec.y +
-              m[ 6] * vec.z +
-              m[ 7] * vec.w;
-    temp.z  = m[ 8] * vec.x +
-              m[ 9] * vec.y +
-              m[10] * vec.z +
-              m[11] * vec.w;
-    temp.w  = m[12] * vec.x +
-              m[13] * vec.y +
-              m[14] * vec.z +
-              m[15] * vec.w;
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR float4 operator*(const Matrix<4,4>& m, const float4& vec )
+  {
+    float4 temp = { m[ 0] * vec.x +
+                    m[ 1] * vec.y +
+                    m[ 2] * vec.z +
+                    m[ 3] * vec.w,
+                    m[ 4] * vec.x +
+                    m[ 5] * vec.y +
+                    m[ 6] * vec.z +
+                    m[ 7] * vec.w,
+                    m[ 8] * vec.x +
+                    m[ 9] * vec.y +
+                    m[10] * vec.z +
+                    m[11] * vec.w,
+                    m[12] * vec.x +
+                    m[13] * vec.y +
+                    m[14] * vec.z +
+                    m[15] * vec.w };
 
     return temp;
   }
@@ -514,7 +521,7 @@ namespace optix {
 
   // Returns the transpose of the matrix.
   template<unsigned int M, unsigned int N>
-  OPTIXU_INLINE RT_HOSTDEVICE Matrix<N,M> Matrix<M,N>::transpose() const
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<N,M> Matrix<M,N>::transpose() const
   {
     Matrix<N,M> ret;
     for( unsigned int row = 0; row < M; ++row )
@@ -651,11 +658,9 @@ namespace optix {
   // Returns the identity matrix.
   // This is a static member.
   template<unsigned int M, unsigned int N>
-  OPTIXU_INLINE RT_HOSTDEVICE Matrix<N,N> Matrix<M,N>::identity()
+  OPTIXU_INLINE RT_HOSTDEVICE OPTIXU_CONSTEXPR Matrix<N,N> Matrix<M,N>::identity()
   {
-    float temp[N*N];
-    for(unsigned int i = 0; i < N*N; ++i)
-      temp[i] = 0;
+    float temp[N*N] = { 0.0f };
     for( unsigned int i = 0; i < N; ++i )
       RT_MATRIX_ACCESS( temp,i,i ) = 1.0f;
     return Matrix<N,N>( temp );
@@ -706,10 +711,117 @@ namespace optix {
     return Mat;
   }
 
+  /** Returns the top three rows of an affine matrix, the last row being assumed to be (0,0,0,1) */
+  OPTIXU_INLINE RT_HOSTDEVICE Matrix<3,4> make_matrix3x4(const Matrix<4,4> &matrix)
+  {
+    return Matrix<3,4>( matrix.getData() );
+  }
+
+  /** Returns the 4x4 matrix of an affine matrix, appending the row (0,0,0,1) */
+  OPTIXU_INLINE RT_HOSTDEVICE Matrix<4,4> make_matrix4x4(const Matrix<3,4> &matrix)
+  {
+    Matrix<4,4> Mat;
+    float *m = Mat.getData();
+    const float *m3x4 = matrix.getData();
+
+    for(unsigned int i = 0; i < 12; ++i)
+      m[i] = m3x4[i];
+    m[12] = 0.0f;
+    m[13] = 0.0f;
+    m[14] = 0.0f;
+    m[15] = 1.0f;
+
+    return Mat;
+  }
+
+  /** Returns the inverse of an affine matrix stored as its top three rows */
+  OPTIXU_INLINE RT_HOSTDEVICE Matrix<3,4> affineInverse(const Matrix<3,4> &matrix)
+  {
+    Matrix<3,4> Mat;
+    float *dst = Mat.getData();
+    const float *m = matrix.getData();
+
+    // Inverse of the linear part from its cofactors
+    const float c0 = m[5]*m[10] - m[6]*m[9];
+    const float c4 = m[6]*m[8]  - m[4]*m[10];
+    const float c8 = m[4]*m[9]  - m[5]*m[8];
+    const float d  = 1.0f / (m[0]*c0 + m[1]*c4 + m[2]*c8);
+
+    dst[0]  = d * c0;
+    dst[1]  = d * (m[2]*m[9]  - m[1]*m[10]);
+    dst[2]  = d * (m[1]*m[6]  - m[2]*m[5]);
+    dst[4]  = d * c4;
+    dst[5]  = d * (m[0]*m[10] - m[2]*m[8]);
+    dst[6]  = d * (m[2]*m[4]  - m[0]*m[6]);
+    dst[8]  = d * c8;
+    dst[9]  = d * (m[1]*m[8]  - m[0]*m[9]);
+    dst[10] = d * (m[0]*m[5]  - m[1]*m[4]);
+
+    // The translation moves back by the inverse of the linear part
+    dst[3]  = -(dst[0]*m[3] + dst[1]*m[7] + dst[2]*m[11]);
+    dst[7]  = -(dst[4]*m[3] + dst[5]*m[7] + dst[6]*m[11]);
+    dst[11] = -(dst[8]*m[3] + dst[9]*m[7] + dst[10]*m[11]);
+
+    return Mat;
+  }
+
+  /** Returns the inverse of a rotation followed by a translation, stored as its top three rows. The linear part
+  * must be orthonormal, so that its inverse is its transpose. */
+  OPTIXU_INLINE RT_HOSTDEVICE Matrix<3,4> rigidInverse(const Matrix<3,4> &matrix)
+  {
+    Matrix<3,4> Mat;
+    float *dst = Mat.getData();
+    const float *m = matrix.getData();
+
+    for(unsigned int i = 0; i < 3; ++i)
+      for(unsigned int j = 0; j < 3; ++j)
+        dst[i*4+j] = m[j*4+i];
+
+    dst[3]  = -(dst[0]*m[3] + dst[1]*m[7] + dst[2]*m[11]);
+    dst[7]  = -(dst[4]*m[3] + dst[5]*m[7] + dst[6]*m[11]);
+    dst[11] = -(dst[8]*m[3] + dst[9]*m[7] + dst[10]*m[11]);
+
+    return Mat;
+  }
+
+  /** Returns the composition of two affine matrices stored as their top three rows, i.e. m1 * m2 as 4x4 matrices */
+  OPTIXU_INLINE RT_HOSTDEVICE Matrix<3,4> affineMultiply(const Matrix<3,4> &m1, const Matrix<3,4> &m2)
+  {
+    Matrix<3,4> Mat;
+    float *dst = Mat.getData();
+    const float *a = m1.getData();
+    const float *b = m2.getData();
+
+    for(unsigned int i = 0; i < 3; ++i) {
+      for(unsigned int j = 0; j < 4; ++j)
+        dst[i*4+j] = a[i*4+0]*b[0*4+j] + a[i*4+1]*b[1*4+j] + a[i*4+2]*b[2*4+j];
+      dst[i*4+3] += a[i*4+3];
+    }
+
+    return Mat;
+  }
+
+  /** Transforms a point by an affine matrix stored as its top three rows */
+  OPTIXU_INLINE RT_HOSTDEVICE float3 transformPoint(const Matrix<3,4> &m, const float3 &p)
+  {
+    return make_float3( m[0]*p.x + m[1]*p.y + m[2]*p.z  + m[3],
+                        m[4]*p.x + m[5]*p.y + m[6]*p.z  + m[7],
+                        m[8]*p.x + m[9]*p.y + m[10]*p.z + m[11] );
+  }
+
+  /** Transforms a direction by an affine matrix stored as its top three rows, ignoring the translation */
+  OPTIXU_INLINE RT_HOSTDEVICE float3 transformVector(const Matrix<3,4> &m, const float3 &v)
+  {
+    return make_float3( m[0]*v.x + m[1]*v.y + m[2]*v.z,
+                        m[4]*v.x + m[5]*v.y + m[6]*v.z,
+                        m[8]*v.x + m[9]*v.y + m[10]*v.z );
+  }
+
 } // end namespace optix
 
 #undef RT_MATRIX_ACCESS
 #undef RT_MAT_DECL
+#undef RT_MATRIX_INIT_DATA
 
 #ifdef OPTIXU_INLINE_DEFINED
 #  undef OPTIXU_INLINE_DEFINED
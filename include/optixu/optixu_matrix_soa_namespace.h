@@ -0,0 +1,168 @@
+
+/*
+ * Copyright (c) 2008 - 2010 NVIDIA Corporation.  All rights reserved.
+ *
+ * NVIDIA Corporation and its licensors retain all intellectual property and proprietary
+ * rights in and to this software, related documentation and any modifications thereto.
+ * Any use, reproduction, disclosure or distribution of this software and related
+ * documentation without an express license agreement from NVIDIA Corporation is strictly
+ * prohibited.
+ *
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, THIS SOFTWARE IS PROVIDED *AS IS*
+ * AND NVIDIA AND ITS SUPPLIERS DISCLAIM ALL WARRANTIES, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE.  IN NO EVENT SHALL NVIDIA OR ITS SUPPLIERS BE LIABLE FOR ANY
+ * SPECIAL, INCIDENTAL, INDIRECT, OR CONSEQUENTIAL DAMAGES WHATSOEVER (INCLUDING, WITHOUT
+ * LIMITATION, DAMAGES FOR LOSS OF BUSINESS PROFITS, BUSINESS INTERRUPTION, LOSS OF
+ * BUSINESS INFORMATION, OR ANY OTHER PECUNIARY LOSS) ARISING OUT OF THE USE OF OR
+ * INABILITY TO USE THIS SOFTWARE, EVEN IF NVIDIA HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES
+ */
+
+ /**
+ * @file   optixu_matrix_soa_namespace.h
+ * @author NVIDIA Corporation
+ * @brief  OptiX public API
+ *
+ * Batch point, vector and normal transforms by a Matrix<4,4> for host code, using the
+ * packets of optixu_math_soa_namespace.h. Not included by optixu_matrix_namespace.h.
+ */
+
+#ifndef __optixu_optixu_matrix_soa_namespace_h__
+#define __optixu_optixu_matrix_soa_namespace_h__
+
+#include "optixu_matrix_namespace.h"
+#include "optixu_math_soa_namespace.h"
+
+#if !defined(__CUDACC__)
+
+// __forceinline__ works in cuda, VS, and with gcc.  Leave it as macro in case
+// we need to make this per-platform or we want to switch off inlining globally.
+#ifndef OPTIXU_INLINE
+#  define OPTIXU_INLINE_DEFINED 1
+#  define OPTIXU_INLINE __forceinline__
+#endif // OPTIXU_INLINE
+
+namespace optix {
+
+  /** @cond */
+  // Transforms count float3s by the 3x4 row-major matrix m and w. Writes to out, or to outX, outY and outZ if out is 0.
+  // With SSE or AVX, consecutive float3s go 8 at a time, transposed to SoA layout in registers. Strided float3s,
+  // the remainder and the scalar backend go one at a time, which beats packing them through memory. Each float3 or
+  // packet is read completely before it is written, so out may equal in.
+  OPTIXU_INLINE void transformBatch( const float* m, float w, RTsize count, const float3* in, unsigned inStride,
+                                     float3* out, unsigned outStride, float* outX, float* outY, float* outZ )
+  {
+    inStride  = inStride  ? inStride  : sizeof(float3);
+    outStride = outStride ? outStride : sizeof(float3);
+
+    RTsize begin = 0;
+#if defined(OPTIXU_SOA_SSE)
+    if( inStride == sizeof(float3) && ( !out || outStride == sizeof(float3) ) ) {
+      const floatx8 m0 = make_floatx8(m[0]), m1 = make_floatx8(m[1]), m2  = make_floatx8(m[2]),  t0 = make_floatx8(m[3]*w);
+      const floatx8 m4 = make_floatx8(m[4]), m5 = make_floatx8(m[5]), m6  = make_floatx8(m[6]),  t1 = make_floatx8(m[7]*w);
+      const floatx8 m8 = make_floatx8(m[8]), m9 = make_floatx8(m[9]), m10 = make_floatx8(m[10]), t2 = make_floatx8(m[11]*w);
+
+      for( ; begin + 8 <= count; begin += 8 ) {
+        // Same order of operations as operator*( Matrix<4,4>, float4 )
+        const float3x8 v = make_float3x8( in + begin );
+        const float3x8 r = make_float3x8( m0*v.x + m1*v.y + m2*v.z  + t0,
+                                          m4*v.x + m5*v.y + m6*v.z  + t1,
+                                          m8*v.x + m9*v.y + m10*v.z + t2 );
+        if( out ) {
+          store( out + begin, r );
+        } else {
+          store( outX + begin, r.x );
+          store( outY + begin, r.y );
+          store( outZ + begin, r.z );
+        }
+      }
+    }
+#endif
+
+    const char* src = reinterpret_cast<const char*>( in );
+    char* dst = reinterpret_cast<char*>( out );
+    // A local copy, so that the compiler need not reload the matrix after every store
+    const float a[12] = { m[0], m[1], m[2],  m[3]*w,
+                          m[4], m[5], m[6],  m[7]*w,
+                          m[8], m[9], m[10], m[11]*w };
+    for( ; begin < count; ++begin ) {
+      const float3 v = *reinterpret_cast<const float3*>( src + begin*inStride );
+      const float x = a[0]*v.x + a[1]*v.y + a[2]*v.z  + a[3];
+      const float y = a[4]*v.x + a[5]*v.y + a[6]*v.z  + a[7];
+      const float z = a[8]*v.x + a[9]*v.y + a[10]*v.z + a[11];
+      if( out ) {
+        float3& r = *reinterpret_cast<float3*>( dst + begin*outStride );
+        r.x = x; r.y = y; r.z = z;
+      } else {
+        outX[begin] = x; outY[begin] = y; outZ[begin] = z;
+      }
+    }
+  }
+
+  // Returns the upper 3x3 of the inverse transpose of m as a 3x4 row-major matrix.
+  OPTIXU_INLINE Matrix<3,4> normalMatrix( const Matrix<4,4>& m )
+  {
+    const Matrix<4,4> inv = m.inverse();
+    Matrix<3,4> n;
+    for( unsigned int i = 0; i < 3; ++i ) {
+      for( unsigned int j = 0; j < 3; ++j )
+        n[i*4+j] = inv[j*4+i];
+      n[i*4+3] = 0.0f;
+    }
+    return n;
+  }
+  /** @endcond */
+
+  /** Transforms count points by m, as make_float3( m * make_float4( p, 1.0f ) ). Strides are in bytes, 0 meaning
+  * consecutive float3s. out may equal in.
+  * @{
+  */
+  OPTIXU_INLINE void transformPoints( const Matrix<4,4>& m, RTsize count, const float3* in, float3* out, unsigned inStride = 0, unsigned outStride = 0 )
+  {
+    transformBatch( m.getData(), 1.0f, count, in, inStride, out, outStride, 0, 0, 0 );
+  }
+  OPTIXU_INLINE void transformPoints( const Matrix<4,4>& m, RTsize count, const float3* in, float* outX, float* outY, float* outZ, unsigned inStride = 0 )
+  {
+    transformBatch( m.getData(), 1.0f, count, in, inStride, 0, 0, outX, outY, outZ );
+  }
+  /** @} */
+
+  /** Transforms count directions by m, as make_float3( m * make_float4( v, 0.0f ) ). Strides are in bytes, 0 meaning
+  * consecutive float3s. out may equal in.
+  * @{
+  */
+  OPTIXU_INLINE void transformVectors( const Matrix<4,4>& m, RTsize count, const float3* in, float3* out, unsigned inStride = 0, unsigned outStride = 0 )
+  {
+    transformBatch( m.getData(), 0.0f, count, in, inStride, out, outStride, 0, 0, 0 );
+  }
+  OPTIXU_INLINE void transformVectors( const Matrix<4,4>& m, RTsize count, const float3* in, float* outX, float* outY, float* outZ, unsigned inStride = 0 )
+  {
+    transformBatch( m.getData(), 0.0f, count, in, inStride, 0, 0, outX, outY, outZ );
+  }
+  /** @} */
+
+  /** Transforms count normals by the inverse transpose of m. The results are not normalized. Strides are in bytes, 0
+  * meaning consecutive float3s. out may equal in.
+  * @{
+  */
+  OPTIXU_INLINE void transformNormals( const Matrix<4,4>& m, RTsize count, const float3* in, float3* out, unsigned inStride = 0, unsigned outStride = 0 )
+  {
+    transformBatch( normalMatrix( m ).getData(), 0.0f, count, in, inStride, out, outStride, 0, 0, 0 );
+  }
+  OPTIXU_INLINE void transformNormals( const Matrix<4,4>& m, RTsize count, const float3* in, float* outX, float* outY, float* outZ, unsigned inStride = 0 )
+  {
+    transformBatch( normalMatrix( m ).getData(), 0.0f, count, in, inStride, 0, 0, outX, outY, outZ );
+  }
+  /** @} */
+
+} // end namespace optix
+
+#ifdef OPTIXU_INLINE_DEFINED
+#  undef OPTIXU_INLINE_DEFINED
+#  undef OPTIXU_INLINE
+#endif
+
+#endif // #if !defined(__CUDACC__)
+
+#endif // #ifndef __optixu_optixu_matrix_soa_namespace_h__